@@ -63,6 +63,7 @@ int main(int argc, char *argv[]) {
     int64_t i, m, n, k, ka, kb, p;
     int64_t check_flag;
     struct timespec ts;
+    mpblas::Mgemm_algo algo = mpblas::Mgemm_algo::automatic;
 
     // initialization
     N0 = M0 = K0 = 1;
@@ -92,6 +93,10 @@ int main(int argc, char *argv[]) {
             } else if (strcmp("-TN", argv[i]) == 0) {
                 transa = 't';
                 transb = 'n';
+            } else if (strcmp("-3M", argv[i]) == 0) {
+                algo = mpblas::Mgemm_algo::gemm3m;
+            } else if (strcmp("-4M", argv[i]) == 0) {
+                algo = mpblas::Mgemm_algo::classical;
             } else if (strcmp("-NOCHECK", argv[i]) == 0) {
                 check_flag = 0;
             } else if (strcmp("-LOOP", argv[i]) == 0) {
@@ -133,19 +138,19 @@ int main(int argc, char *argv[]) {
         alpha = urdist(engine);
         beta = urdist(engine);
         for (i = 0; i < lda * ka; i++) {
-            a[i] = urdist(engine);
+            a[i] = std::complex<mpf_class>(urdist(engine), urdist(engine));
         }
         for (i = 0; i < ldb * kb; i++) {
-            b[i] = urdist(engine);
+            b[i] = std::complex<mpf_class>(urdist(engine), urdist(engine));
         }
         for (i = 0; i < ldc * n; i++) {
-            c[i] = urdist(engine);
+            c[i] = std::complex<mpf_class>(urdist(engine), urdist(engine));
         }
         elapsedtime_l = 0;
         for (int j = 0; j < LOOP; j++) {
             clock_gettime(CLOCK_REALTIME, &ts);
             t1 = ts.tv_nsec;
-            mpblas::Cgemm<mpf_class>(&transa, &transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+            mpblas::Cgemm<mpf_class>(&transa, &transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
             clock_gettime(CLOCK_REALTIME, &ts);
             t2 = ts.tv_nsec;
             elapsedtime_l = elapsedtime_l + t2 - t1;
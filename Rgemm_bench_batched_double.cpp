@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+
+#include <time.h>
+#include "mpblas.hpp"
+
+#define MFLOPS 1e-6
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int64_t k_i, int64_t m_i, int64_t n_i) {
+    double adds, muls, flops;
+    double k, m, n;
+    m = (double)m_i;
+    n = (double)n_i;
+    k = (double)k_i;
+    muls = m * (k + 2) * n;
+    adds = m * k * n;
+    flops = muls + adds;
+    return flops;
+}
+
+double elapsed(struct timespec const &t1, struct timespec const &t2) { return (double)(t2.tv_sec - t1.tv_sec) + (double)(t2.tv_nsec - t1.tv_nsec) * NANOSECOND; }
+
+//
+//     Throughput of BATCH independent m x n x k products, square by default
+//     from 8 to 64: one Rgemm call per product against one
+//     Rgemm_strided_batched call for the whole batch.
+//
+int main(int argc, char *argv[]) {
+    double alpha, beta;
+    double time_loop, time_batched;
+    char transa, transb;
+    int64_t N0, M0, K0, STEPN = 8, STEPM = 8, STEPK = 8, LOOP = 3, TOTALSTEPS = 8, BATCH = 4096;
+    int64_t lda, ldb, ldc;
+    int64_t i, m, n, k, ka, kb, p, q;
+    struct timespec t1, t2;
+
+    // initialization
+    N0 = M0 = K0 = 8;
+    transa = transb = 'n';
+    if (argc != 1) {
+        for (i = 1; i < argc; i++) {
+            if (strcmp("-N", argv[i]) == 0) {
+                N0 = atoi(argv[++i]);
+            } else if (strcmp("-M", argv[i]) == 0) {
+                M0 = atoi(argv[++i]);
+            } else if (strcmp("-K", argv[i]) == 0) {
+                K0 = atoi(argv[++i]);
+            } else if (strcmp("-STEPN", argv[i]) == 0) {
+                STEPN = atoi(argv[++i]);
+            } else if (strcmp("-STEPM", argv[i]) == 0) {
+                STEPM = atoi(argv[++i]);
+            } else if (strcmp("-STEPK", argv[i]) == 0) {
+                STEPK = atoi(argv[++i]);
+            } else if (strcmp("-BATCH", argv[i]) == 0) {
+                BATCH = atoi(argv[++i]);
+            } else if (strcmp("-NN", argv[i]) == 0) {
+                transa = transb = 'n';
+            } else if (strcmp("-TT", argv[i]) == 0) {
+                transa = transb = 't';
+            } else if (strcmp("-NT", argv[i]) == 0) {
+                transa = 'n';
+                transb = 't';
+            } else if (strcmp("-TN", argv[i]) == 0) {
+                transa = 't';
+                transb = 'n';
+            } else if (strcmp("-LOOP", argv[i]) == 0) {
+                LOOP = atoi(argv[++i]);
+            } else if (strcmp("-TOTALSTEPS", argv[i]) == 0) {
+                TOTALSTEPS = atoi(argv[++i]);
+            }
+        }
+    }
+
+    std::random_device seed_gen;
+    std::mt19937 engine(seed_gen());
+    std::uniform_real_distribution<> urdist(-1.0, 1.0);
+
+    printf("    m     n     k  batch  MFLOPS(loop)  MFLOPS(batched)  products/s(batched)  transa   transb\n");
+    m = M0;
+    n = N0;
+    k = K0;
+    for (p = 0; p < TOTALSTEPS; p++) {
+        if (Mlsame(&transa, "n")) {
+            ka = k;
+            lda = m;
+        } else {
+            ka = m;
+            lda = k;
+        }
+        if (Mlsame(&transb, "n")) {
+            kb = n;
+            ldb = k;
+        } else {
+            kb = k;
+            ldb = n;
+        }
+        ldc = m;
+
+        double *a = new double[lda * ka * BATCH];
+        double *b = new double[ldb * kb * BATCH];
+        double *c = new double[ldc * n * BATCH];
+        alpha = urdist(engine);
+        beta = urdist(engine);
+        for (i = 0; i < lda * ka * BATCH; i++) {
+            a[i] = urdist(engine);
+        }
+        for (i = 0; i < ldb * kb * BATCH; i++) {
+            b[i] = urdist(engine);
+        }
+        for (i = 0; i < ldc * n * BATCH; i++) {
+            c[i] = urdist(engine);
+        }
+        time_loop = time_batched = 0.0;
+        for (int j = 0; j < LOOP; j++) {
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            for (q = 0; q < BATCH; q++) {
+                mpblas::Rgemm<double>(&transa, &transb, m, n, k, alpha, &a[q * lda * ka], lda, &b[q * ldb * kb], ldb, beta, &c[q * ldc * n], ldc);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t2);
+            time_loop += elapsed(t1, t2);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            mpblas::Rgemm_strided_batched<double>(&transa, &transb, m, n, k, alpha, a, lda, lda * ka, b, ldb, ldb * kb, beta, c, ldc, ldc * n, BATCH);
+            clock_gettime(CLOCK_MONOTONIC, &t2);
+            time_batched += elapsed(t1, t2);
+        }
+        time_loop /= (double)LOOP;
+        time_batched /= (double)LOOP;
+        printf("%5d %5d %5d %6d %13.3f %16.3f %20.1f         %c        %c\n", (int)m, (int)n, (int)k, (int)BATCH, flops_gemm(k, m, n) * BATCH / time_loop * MFLOPS, flops_gemm(k, m, n) * BATCH / time_batched * MFLOPS, (double)BATCH / time_batched, transa, transb);
+        delete[] c;
+        delete[] b;
+        delete[] a;
+        m = m + STEPM;
+        n = n + STEPN;
+        k = k + STEPK;
+    }
+}
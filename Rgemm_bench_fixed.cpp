@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <chrono>
+
+#include <qd/qd_real.h>
+#include <quadmath.h>
+
+#include "mpblas.hpp"
+#include "typetype.hpp"
+
+#define MFLOPS 1e-6
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int64_t k_i, int64_t m_i, int64_t n_i) {
+  double adds, muls, flops;
+  double k, m, n;
+  m = (double)m_i;
+  n = (double)n_i;
+  k = (double)k_i;
+  muls = m * (k + 2) * n;
+  adds = m * k * n;
+  flops = muls + adds;
+  return flops;
+}
+
+double flops_gemv(int64_t m_i, int64_t n_i) {
+  double m = (double)m_i, n = (double)n_i;
+  return 2.0 * m * n + 2.0 * m;
+}
+
+//
+// Time CALLS calls of the dynamic Rgemm and Rgemv and of Rgemm_fixed and
+// Rgemv_fixed on one N x N x N (N x N) problem that stays in L1, and report
+// nanoseconds per call and MFLOPS.
+//
+template <typename REAL, int N>
+void bench(int64_t CALLS) {
+  std::random_device seed_gen;
+  std::mt19937 engine(seed_gen());
+  std::uniform_real_distribution<> urdist(-1.0, 1.0);
+
+  REAL alpha = urdist(engine), beta = urdist(engine);
+  REAL a[N * N], b[N * N], c[N * N], x[N], y[N];
+  for (int i = 0; i < N * N; i++) {
+    a[i] = urdist(engine);
+    b[i] = urdist(engine);
+    c[i] = urdist(engine);
+  }
+  for (int i = 0; i < N; i++) {
+    x[i] = urdist(engine);
+    y[i] = urdist(engine);
+  }
+  double elapsed[4];
+  for (int t = 0; t < 4; t++) {
+    std::chrono::steady_clock::time_point time_before = std::chrono::steady_clock::now();
+    for (int64_t p = 0; p < CALLS; p++) {
+      switch (t) {
+      case 0:
+	mpblas::Rgemm<REAL>("n", "n", N, N, N, alpha, a, N, b, N, beta, c, N);
+	break;
+      case 1:
+	mpblas::Rgemm_fixed<N, N, N>(alpha, a, N, b, N, beta, c, N);
+	break;
+      case 2:
+	mpblas::Rgemv<REAL>("n", N, N, alpha, a, N, x, 1, beta, y, 1);
+	break;
+      case 3:
+	mpblas::Rgemv_fixed<N, N>(alpha, a, N, x, 1, beta, y, 1);
+	break;
+      }
+    }
+    std::chrono::steady_clock::time_point time_after = std::chrono::steady_clock::now();
+    elapsed[t] = std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before).count() / (double)CALLS;
+  }
+  printf("%-12s %2d %10.1f %10.1f %10.3f %10.3f %10.1f %10.1f %10.3f %10.3f\n", TypeNameCstr<REAL>(), N, elapsed[0], elapsed[1], flops_gemm(N, N, N) / (elapsed[0] * NANOSECOND) * MFLOPS, flops_gemm(N, N, N) / (elapsed[1] * NANOSECOND) * MFLOPS, elapsed[2], elapsed[3], flops_gemv(N, N) / (elapsed[2] * NANOSECOND) * MFLOPS, flops_gemv(N, N) / (elapsed[3] * NANOSECOND) * MFLOPS);
+}
+
+template <typename REAL>
+void bench_sizes(int64_t CALLS) {
+  bench<REAL, 2>(CALLS);
+  bench<REAL, 4>(CALLS);
+  bench<REAL, 6>(CALLS);
+  bench<REAL, 8>(CALLS);
+}
+
+int main(int argc, char *argv[]) {
+  int64_t CALLS = 1000000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp("-CALLS", argv[i]) == 0) {
+      CALLS = atoi(argv[++i]);
+    }
+  }
+  printf("type          n   gemm(ns)  fixed(ns)     MFLOPS      fixed   gemv(ns)  fixed(ns)     MFLOPS      fixed\n");
+  bench_sizes<float>(CALLS);
+  bench_sizes<double>(CALLS);
+  bench_sizes<dd_real>(CALLS / 10);
+  bench_sizes<qd_real>(CALLS / 100);
+  bench_sizes<_Float128>(CALLS / 100);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+
+#include <time.h>
+#include <omp.h>
+#include "mpblas.hpp"
+
+#define MFLOPS 1e-6
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int64_t k_i, int64_t m_i, int64_t n_i) {
+    double adds, muls, flops;
+    double k, m, n;
+    m = (double)m_i;
+    n = (double)n_i;
+    k = (double)k_i;
+    muls = m * (k + 2) * n;
+    adds = m * k * n;
+    flops = muls + adds;
+    return flops;
+}
+
+double elapsed(struct timespec const &t1, struct timespec const &t2) { return (double)(t2.tv_sec - t1.tv_sec) + (double)(t2.tv_nsec - t1.tv_nsec) * NANOSECOND; }
+
+//
+//     Scaling of a square double Rgemm from one NUMA node to all of them, with
+//     the NUMA mode of mpblas/Mnuma.hpp on and off.  For s nodes the threads
+//     are all CPUs of the first s nodes.  B and C are first touched by the
+//     tiles that will use them, so they are local in NUMA mode; A is read by
+//     every node.  Efficiency is MFLOPS per thread relative to one node.
+//
+double run(int64_t n, int64_t nthreads, bool numa, int64_t LOOP) {
+    mpblas::Mnuma_mode() = numa;
+    omp_set_num_threads((int)nthreads);
+    const int64_t mr = mpblas::Rgemm_kernel<double>::mr();
+    const int64_t nr = mpblas::Rgemm_kernel<double>::nr();
+    double *a = new double[n * n];
+    double *b = new double[n * n];
+    double *c = new double[n * n];
+    for (int64_t i = 0; i < n * n; i++) {
+        a[i] = (double)((i * 7919) % 1000) / 1000.0 - 0.5;
+    }
+    mpblas::Mparallel_tiles(n, n, mr, nr, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1) {
+        for (int64_t j = j0; j < j1; j++) {
+            for (int64_t i = i0; i < i1; i++) {
+                b[i + j * n] = (double)(((i + j * n) * 104729) % 1000) / 1000.0 - 0.5;
+                c[i + j * n] = 0.0;
+            }
+        }
+    });
+    double best = 0.0;
+    struct timespec t1, t2;
+    for (int64_t l = 0; l < LOOP; l++) {
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        mpblas::Rgemm<double>("n", "n", n, n, n, 1.0, a, n, b, n, 0.0, c, n);
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+        best = std::max(best, flops_gemm(n, n, n) / elapsed(t1, t2) * MFLOPS);
+    }
+    delete[] c;
+    delete[] b;
+    delete[] a;
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    int64_t N = 4096, LOOP = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp("-N", argv[i]) == 0) {
+            N = atoi(argv[++i]);
+        } else if (strcmp("-LOOP", argv[i]) == 0) {
+            LOOP = atoi(argv[++i]);
+        }
+    }
+    std::vector<std::vector<int>> const &nodes = mpblas::Mnuma_nodes();
+    printf("%d NUMA node(s), n = %d\n", (int)nodes.size(), (int)N);
+    printf("nodes threads  MFLOPS(numa)  efficiency  MFLOPS(plain)  efficiency\n");
+    int64_t nthreads = 0;
+    double base_numa = 0.0, base_plain = 0.0;
+    for (size_t s = 0; s < nodes.size(); s++) {
+        nthreads += std::max((int64_t)1, (int64_t)nodes[s].size());
+        double numa = run(N, nthreads, true, LOOP);
+        double plain = run(N, nthreads, false, LOOP);
+        if (s == 0) {
+            base_numa = numa / (double)nthreads;
+            base_plain = plain / (double)nthreads;
+        }
+        printf("%5d %7d %13.3f %11.3f %14.3f %11.3f\n", (int)(s + 1), (int)nthreads, numa, numa / (double)nthreads / base_numa, plain, plain / (double)nthreads / base_plain);
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <chrono>
+
+#include <gmpxx.h>
+#include <qd/qd_real.h>
+#include <quadmath.h>
+
+#include "mpblas.hpp"
+#include "typetype.hpp"
+
+#define MFLOPS 1e-6
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int64_t k_i, int64_t m_i, int64_t n_i) {
+  double adds, muls, flops;
+  double k, m, n;
+  m = (double)m_i;
+  n = (double)n_i;
+  k = (double)k_i;
+  muls = m * (k + 2) * n;
+  adds = m * k * n;
+  flops = muls + adds;
+  return flops;
+}
+
+//
+// Sweep n = m = k and time one level of Strassen-Winograd (crossover set to
+// n, so the seven products of size n/2 run on the blocked engine) against
+// the classical blocked path.  The crossover is the first size from which
+// Strassen-Winograd stays ahead for the rest of the sweep.
+//
+template <typename REAL>
+void bench(int argc, char *argv[]) {
+  REAL alpha, beta;
+  double elapsedtime, elapsedtime_strassen;
+
+  char transa, transb;
+  int64_t N0 = 32, STEPN = 32, LOOP = 3, TOTALSTEPS = 16;
+  int64_t i, n, p;
+  int64_t crossover = -1;
+
+  std::cout << "Test for " << TypeName<REAL>() << "\n";
+
+  transa = transb = 'n';
+  if (argc != 1) {
+    for (i = 1; i < argc; i++) {
+      if (strcmp("-N", argv[i]) == 0) {
+	N0 = atoi(argv[++i]);
+      } else if (strcmp("-STEPN", argv[i]) == 0) {
+	STEPN = atoi(argv[++i]);
+      } else if (strcmp("-NN", argv[i]) == 0) {
+	transa = transb = 'n';
+      } else if (strcmp("-TT", argv[i]) == 0) {
+	transa = transb = 't';
+      } else if (strcmp("-NT", argv[i]) == 0) {
+	transa = 'n';
+	transb = 't';
+      } else if (strcmp("-TN", argv[i]) == 0) {
+	transa = 't';
+	transb = 'n';
+      } else if (strcmp("-LOOP", argv[i]) == 0) {
+	LOOP = atoi(argv[++i]);
+      } else if (strcmp("-TOTALSTEPS", argv[i]) == 0) {
+	TOTALSTEPS = atoi(argv[++i]);
+      }
+    }
+  }
+
+  std::random_device seed_gen;
+  std::mt19937 engine(seed_gen());
+  std::uniform_real_distribution<> urdist(-1.0, 1.0);
+
+  printf("    n  classical MFLOPS  strassen MFLOPS  transa   transb\n");
+  n = N0;
+  for (p = 0; p < TOTALSTEPS; p++) {
+    REAL *a = new REAL [n * n];
+    REAL *b = new REAL [n * n];
+    REAL *c = new REAL [n * n];
+    alpha = urdist(engine);
+    beta = urdist(engine);
+    for (i = 0; i < n * n; i++) {
+      a[i] = urdist(engine);
+    }
+    for (i = 0; i < n * n; i++) {
+      b[i] = urdist(engine);
+    }
+    for (i = 0; i < n * n; i++) {
+      c[i] = urdist(engine);
+    }
+    mpblas::Rgemm_strassen_cutoff<REAL>() = n;
+    elapsedtime = 0.0;
+    elapsedtime_strassen = 0.0;
+    for (int j = 0; j < LOOP; j++) {
+      std::chrono::steady_clock::time_point time_before;
+      std::chrono::steady_clock::time_point time_after;
+
+      time_before = std::chrono::steady_clock::now();
+      mpblas::Rgemm<REAL>(&transa, &transb, n, n, n, alpha, a, n, b, n, beta, c, n, mpblas::Mgemm_algo::classical);
+      time_after = std::chrono::steady_clock::now();
+      elapsedtime += std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before).count();
+
+      time_before = std::chrono::steady_clock::now();
+      mpblas::Rgemm<REAL>(&transa, &transb, n, n, n, alpha, a, n, b, n, beta, c, n, mpblas::Mgemm_algo::strassen);
+      time_after = std::chrono::steady_clock::now();
+      elapsedtime_strassen += std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before).count();
+    }
+    mpblas::Rgemm_strassen_cutoff<REAL>() = 0;
+    elapsedtime = elapsedtime * NANOSECOND / (double)LOOP;
+    elapsedtime_strassen = elapsedtime_strassen * NANOSECOND / (double)LOOP;
+    if (elapsedtime_strassen < elapsedtime) {
+      if (crossover < 0) {
+	crossover = n;
+      }
+    } else {
+      crossover = -1;
+    }
+    printf("%5d %17.3f %16.3f         %c        %c\n", (int)n, flops_gemm(n, n, n) / elapsedtime * MFLOPS, flops_gemm(n, n, n) / elapsedtime_strassen * MFLOPS, transa, transb);
+    delete[] c;
+    delete[] b;
+    delete[] a;
+    n = n + STEPN;
+  }
+  if (crossover < 0) {
+    printf("crossover for %s: beyond n = %d (default %d)\n", TypeNameCstr<REAL>(), (int)(n - STEPN), (int)mpblas::Rgemm_strassen_crossover<REAL>());
+  } else {
+    printf("crossover for %s: n = %d (default %d)\n", TypeNameCstr<REAL>(), (int)crossover, (int)mpblas::Rgemm_strassen_crossover<REAL>());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  bench<_Float16>(argc, argv);
+  bench<float>(argc, argv);
+  bench<double>(argc, argv);
+  bench<dd_real>(argc, argv);
+  bench<qd_real>(argc, argv);
+  bench<_Float128>(argc, argv);
+  bench<mpf_class>(argc, argv);
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gmpxx.h>
+#include <qd/qd_real.h>
+#include <quadmath.h>
+
+#include "mpblas.hpp"
+#include "typetype.hpp"
+
+#define MFLOPS 1e-6
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int64_t k_i, int64_t m_i, int64_t n_i) {
+  double adds, muls, flops;
+  double k, m, n;
+  m = (double)m_i;
+  n = (double)n_i;
+  k = (double)k_i;
+  muls = m * (k + 2) * n;
+  adds = m * k * n;
+  flops = muls + adds;
+  return flops;
+}
+
+//
+// Search the register tile and the cache blocks of the blocked engine for
+// each type of Rgemm_bench_all and write them to the tuning file read by
+// mpblas (see mpblas/Rgemm_tuning.hpp).  For every register tile the kernel
+// offers, kc, mc and nc are tuned one after the other on an n x n x n
+// product, keeping the others fixed; the fastest combination is kept.
+//
+//   -N n        problem size (default: by type, 512 for the hardware types)
+//   -LOOP l     timed runs per candidate, the fastest counts (default 3)
+//   -PREC bits  precision of mpf_class (default 512)
+//   -O file     output file (default: $MPBLAS_TUNING or mpblas_tuning.txt)
+//
+template <typename REAL>
+double run(int64_t n, int64_t LOOP, REAL *a, REAL *b, REAL *c, mpblas::Rgemm_tuning const &t) {
+  REAL alpha = 1.0, beta = 0.0;
+  double best = 0.0;
+  mpblas::Rgemm_tuning_override<REAL>() = t;
+  for (int j = 0; j < LOOP; j++) {
+    std::chrono::steady_clock::time_point time_before;
+    std::chrono::steady_clock::time_point time_after;
+
+    time_before = std::chrono::steady_clock::now();
+    mpblas::Rgemm<REAL>("n", "n", n, n, n, alpha, a, n, b, n, beta, c, n, mpblas::Mgemm_algo::classical);
+    time_after = std::chrono::steady_clock::now();
+    double elapsedtime = std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before).count() * NANOSECOND;
+    double mflops = flops_gemm(n, n, n) / elapsedtime * MFLOPS;
+    if (mflops > best) {
+      best = mflops;
+    }
+  }
+  mpblas::Rgemm_tuning_override<REAL>() = mpblas::Rgemm_tuning();
+  return best;
+}
+
+template <typename REAL>
+std::string tune(int argc, char *argv[]) {
+  int64_t N = 0, LOOP = 3;
+  int64_t i;
+
+  std::cout << "Tuning for " << TypeName<REAL>() << "\n";
+
+  if (argc != 1) {
+    for (i = 1; i < argc; i++) {
+      if (strcmp("-N", argv[i]) == 0) {
+	N = atoi(argv[++i]);
+      } else if (strcmp("-LOOP", argv[i]) == 0) {
+	LOOP = atoi(argv[++i]);
+      }
+    }
+  }
+  if (N <= 0) {
+    N = (sizeof(REAL) <= 8) ? 512 : (sizeof(REAL) <= 16) ? 256 : 128;
+  }
+
+  std::random_device seed_gen;
+  std::mt19937 engine(seed_gen());
+  std::uniform_real_distribution<> urdist(-1.0, 1.0);
+
+  REAL *a = new REAL [N * N];
+  REAL *b = new REAL [N * N];
+  REAL *c = new REAL [N * N];
+  for (i = 0; i < N * N; i++) {
+    a[i] = urdist(engine);
+    b[i] = urdist(engine);
+    c[i] = urdist(engine);
+  }
+
+  const int64_t kcs[] = {32, 64, 96, 128, 192, 256, 384, 512};
+  const int64_t mcs[] = {32, 64, 96, 128, 192, 256, 384, 512};
+  const int64_t ncs[] = {256, 512, 1024, 2048, 4096, 8192};
+  mpblas::Rgemm_tuning best;
+  double best_mflops = 0.0;
+  const std::pair<int64_t, int64_t> initial = {mpblas::Rgemm_kernel<REAL>::mr(), mpblas::Rgemm_kernel<REAL>::nr()};
+  printf("   mr   nr     mc     kc     nc     MFLOPS\n");
+  for (std::pair<int64_t, int64_t> const &shape : mpblas::Rgemm_shapes<REAL>::list()) {
+    mpblas::Rgemm_shapes<REAL>::use(shape.first, shape.second);
+    mpblas::Rgemm_tuning t;
+    t.mr = shape.first;
+    t.nr = shape.second;
+    t.mc = mpblas::Rgemm_blocking<REAL>::MC;
+    t.kc = mpblas::Rgemm_blocking<REAL>::KC;
+    t.nc = mpblas::Rgemm_blocking<REAL>::NC;
+    double mflops = run(N, LOOP, a, b, c, t);
+    for (int pass = 0; pass < 3; pass++) {
+      int64_t const *values = (pass == 0) ? kcs : (pass == 1) ? mcs : ncs;
+      int64_t nvalues = (pass == 2) ? 6 : 8;
+      int64_t *field = (pass == 0) ? &t.kc : (pass == 1) ? &t.mc : &t.nc;
+      for (int64_t v = 0; v < nvalues; v++) {
+	int64_t keep = *field;
+	*field = values[v];
+	double m = run(N, LOOP, a, b, c, t);
+	if (m > mflops) {
+	  mflops = m;
+	} else {
+	  *field = keep;
+	}
+      }
+    }
+    printf("%5d %4d %6d %6d %6d %10.3f\n", (int)t.mr, (int)t.nr, (int)t.mc, (int)t.kc, (int)t.nc, mflops);
+    if (mflops > best_mflops) {
+      best_mflops = mflops;
+      best = t;
+    }
+  }
+  mpblas::Rgemm_shapes<REAL>::use(initial.first, initial.second);
+  delete[] c;
+  delete[] b;
+  delete[] a;
+
+  char line[512];
+  snprintf(line, sizeof(line), "%s %llu %lld %lld %lld %lld %lld\n", mpblas::Rgemm_tuning_name<REAL>::name(), (unsigned long long)mpblas::Mbuffer_format<REAL>::current(), (long long)best.mc, (long long)best.kc, (long long)best.nc, (long long)best.mr, (long long)best.nr);
+  printf("best: %s", line);
+  return line;
+}
+
+int main(int argc, char *argv[]) {
+  int64_t PREC = 512;
+  const char *file = mpblas::Rgemm_tuning_file();
+  for (int i = 1; i < argc; i++) {
+    if (strcmp("-PREC", argv[i]) == 0) {
+      PREC = atoi(argv[++i]);
+    } else if (strcmp("-O", argv[i]) == 0) {
+      file = argv[++i];
+    }
+  }
+  mpf_set_default_prec(PREC);
+
+  std::vector<std::string> lines;
+  lines.push_back(tune<_Float16>(argc, argv));
+  lines.push_back(tune<float>(argc, argv));
+  lines.push_back(tune<double>(argc, argv));
+  lines.push_back(tune<dd_real>(argc, argv));
+  lines.push_back(tune<qd_real>(argc, argv));
+  lines.push_back(tune<_Float128>(argc, argv));
+  lines.push_back(tune<mpf_class>(argc, argv));
+
+  //
+  // Keep the entries of the output file that were not tuned again (mpf_class
+  // at other precisions, for instance).  The new file is written next to it
+  // and renamed over it, so that it is replaced only when complete.
+  //
+  const std::vector<mpblas::Rgemm_tuning_entry> old = mpblas::Rgemm_tuning_read(file);
+  const std::string tmp = std::string(file) + ".tmp";
+  FILE *fp = fopen(tmp.c_str(), "w");
+  if (fp == nullptr) {
+    fprintf(stderr, "cannot write %s\n", tmp.c_str());
+    return 1;
+  }
+  fprintf(fp, "# type format mc kc nc mr nr, written by Rgemm_tune\n");
+  for (mpblas::Rgemm_tuning_entry const &e : old) {
+    char key[300];
+    snprintf(key, sizeof(key), "%s %llu ", e.name.c_str(), (unsigned long long)e.format);
+    bool retuned = false;
+    for (std::string const &l : lines) {
+      retuned = retuned || (l.compare(0, strlen(key), key) == 0);
+    }
+    if (!retuned) {
+      fprintf(fp, "%s %llu %lld %lld %lld %lld %lld\n", e.name.c_str(), (unsigned long long)e.format, (long long)e.tuning.mc, (long long)e.tuning.kc, (long long)e.tuning.nc, (long long)e.tuning.mr, (long long)e.tuning.nr);
+    }
+  }
+  for (std::string const &l : lines) {
+    fputs(l.c_str(), fp);
+  }
+  if ((fclose(fp) != 0) || (rename(tmp.c_str(), file) != 0)) {
+    fprintf(stderr, "cannot write %s\n", file);
+    remove(tmp.c_str());
+    return 1;
+  }
+  printf("wrote %s\n", file);
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <chrono>
+
+#include <gmpxx.h>
+#include <qd/qd_real.h>
+#include <quadmath.h>
+
+#include "mpblas.hpp"
+#include "typetype.hpp"
+
+#define MFLOPS 1e-6
+#define GBYTES 1e-9
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemv(int64_t m_i, int64_t n_i, int64_t leny_i) {
+  double adds, muls, flops;
+  double m, n, leny;
+  m = (double)m_i;
+  n = (double)n_i;
+  leny = (double)leny_i;
+  muls = m * n + 2 * leny;
+  adds = m * n;
+  flops = muls + adds;
+  return flops;
+}
+
+// storage of one element; for mpf_class, including its limbs
+template <typename REAL> double bytes_per_element() { return (double)sizeof(REAL); }
+template <> double bytes_per_element<mpf_class>() {
+  return (double)(sizeof(mpf_class) + ((mpf_get_default_prec() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS + 1) * sizeof(mp_limb_t));
+}
+
+// A is read once, x once, y read and written once
+double bytes_gemv(int64_t m_i, int64_t n_i, int64_t lenx_i, int64_t leny_i, double size) {
+  return ((double)m_i * (double)n_i + (double)lenx_i + 2.0 * (double)leny_i) * size;
+}
+
+template <typename REAL>
+void bench(int argc, char *argv[]) {
+  REAL alpha, beta;
+  double elapsedtime;
+
+  char transes[2] = {'n', 't'};
+  int64_t ntrans = 2, trans0 = 0;
+  int64_t incs[2][2] = {{1, 1}, {3, -2}};
+  int64_t nincs = 2, inc0 = 0;
+  int64_t N0, M0, STEPN = 3, STEPM = 3, LOOP = 3, TOTALSTEPS = 400;
+  int64_t lda;
+  int64_t i, m, n, lenx, leny, p;
+
+  std::cout << "Test for " << TypeName<REAL>() << "\n";
+
+  // initialization
+  N0 = M0 = 1;
+  if (argc != 1) {
+    for (i = 1; i < argc; i++) {
+      if (strcmp("-N", argv[i]) == 0) {
+	N0 = atoi(argv[++i]);
+      } else if (strcmp("-M", argv[i]) == 0) {
+	M0 = atoi(argv[++i]);
+      } else if (strcmp("-STEPN", argv[i]) == 0) {
+	STEPN = atoi(argv[++i]);
+      } else if (strcmp("-STEPM", argv[i]) == 0) {
+	STEPM = atoi(argv[++i]);
+      } else if (strcmp("-NOTRANS", argv[i]) == 0) {
+	trans0 = 0;
+	ntrans = 1;
+      } else if (strcmp("-TRANS", argv[i]) == 0) {
+	trans0 = 1;
+	ntrans = 1;
+      } else if (strcmp("-INCX", argv[i]) == 0) {
+	incs[1][0] = atoi(argv[++i]);
+      } else if (strcmp("-INCY", argv[i]) == 0) {
+	incs[1][1] = atoi(argv[++i]);
+      } else if (strcmp("-UNIT", argv[i]) == 0) {
+	inc0 = 0;
+	nincs = 1;
+      } else if (strcmp("-STRIDED", argv[i]) == 0) {
+	inc0 = 1;
+	nincs = 1;
+      } else if (strcmp("-LOOP", argv[i]) == 0) {
+	LOOP = atoi(argv[++i]);
+      } else if (strcmp("-TOTALSTEPS", argv[i]) == 0) {
+	TOTALSTEPS = atoi(argv[++i]);
+      }
+    }
+  }
+
+  std::random_device seed_gen;
+  std::mt19937 engine(seed_gen());
+  std::uniform_real_distribution<> urdist(-1.0, 1.0);
+
+  m = M0;
+  n = N0;
+  for (p = 0; p < TOTALSTEPS; p++) {
+    lda = m;
+    printf("    m     n  trans  incx  incy     MFLOPS       GB/s\n");
+    for (int64_t t = trans0; t < trans0 + ntrans; t++) {
+      for (int64_t s = inc0; s < inc0 + nincs; s++) {
+	char trans = transes[t];
+	int64_t incx = incs[s][0];
+	int64_t incy = incs[s][1];
+	if (Mlsame(&trans, "n")) {
+	  lenx = n;
+	  leny = m;
+	} else {
+	  lenx = m;
+	  leny = n;
+	}
+	int64_t sizex = 1 + (lenx - 1) * std::abs(incx);
+	int64_t sizey = 1 + (leny - 1) * std::abs(incy);
+
+	REAL *a = new REAL [lda * n];
+	REAL *x = new REAL [sizex];
+	REAL *y = new REAL [sizey];
+	alpha = urdist(engine);
+	beta = urdist(engine);
+	for (i = 0; i < lda * n; i++) {
+	  a[i] = urdist(engine);
+	}
+	for (i = 0; i < sizex; i++) {
+	  x[i] = urdist(engine);
+	}
+	for (i = 0; i < sizey; i++) {
+	  y[i] = urdist(engine);
+	}
+	elapsedtime = 0.0;
+	for (int j = 0; j < LOOP; j++) {
+	  std::chrono::steady_clock::time_point time_before;
+	  std::chrono::steady_clock::time_point time_after;
+
+	  time_before = std::chrono::steady_clock::now();
+	  mpblas::Rgemv<REAL>(&trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+	  time_after = std::chrono::steady_clock::now();
+	  double time_in_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before).count();
+
+	  elapsedtime += time_in_ns;
+	}
+	elapsedtime = elapsedtime * NANOSECOND / (double)LOOP;
+	printf("%5d %5d      %c %5d %5d %10.3f %10.3f\n", (int)m, (int)n, trans, (int)incx, (int)incy, flops_gemv(m, n, leny) / elapsedtime * MFLOPS,
+	       bytes_gemv(m, n, lenx, leny, bytes_per_element<REAL>()) / elapsedtime * GBYTES);
+	delete[] y;
+	delete[] x;
+	delete[] a;
+      }
+    }
+    m = m + STEPM;
+    n = n + STEPN;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  bench<_Float16>(argc, argv);
+  bench<float>(argc, argv);
+  bench<double>(argc, argv);
+  bench<dd_real>(argc, argv);
+  bench<qd_real>(argc, argv);
+  bench<_Float128>(argc, argv);
+  bench<mpf_class>(argc, argv);
+}
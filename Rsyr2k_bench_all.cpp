@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2008-2022
+ *	Nakata, Maho
+ * 	All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <chrono>
+
+#include <gmpxx.h>
+#include <qd/qd_real.h>
+#include <quadmath.h>
+
+#include "mpblas.hpp"
+#include "typetype.hpp"
+
+#define MFLOPS 1e-6
+#define NANOSECOND 1e-9
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_syr2k(int64_t k_i, int64_t n_i) {
+  double adds, muls, flops;
+  double k, n;
+  n = (double)n_i;
+  k = (double)k_i;
+  muls = k * n * n + n;
+  adds = k * n * n + n;
+  flops = muls + adds;
+  return flops;
+}
+
+template <typename REAL>
+void bench(int argc, char *argv[]) {
+  REAL alpha, beta;
+  double elapsedtime;
+
+  char uplo, trans;
+  int64_t N0, K0, STEPN = 3, STEPK = 3, LOOP = 3, TOTALSTEPS = 400;
+  int64_t lda, ldb, ldc;
+  int64_t i, n, k, ka, p;
+
+  std::cout << "Test for " << TypeName<REAL>() << "\n";
+
+  // initialization
+  N0 = K0 = 1;
+  uplo = 'u';
+  trans = 'n';
+  if (argc != 1) {
+    for (i = 1; i < argc; i++) {
+      if (strcmp("-N", argv[i]) == 0) {
+	N0 = atoi(argv[++i]);
+      } else if (strcmp("-K", argv[i]) == 0) {
+	K0 = atoi(argv[++i]);
+      } else if (strcmp("-STEPN", argv[i]) == 0) {
+	STEPN = atoi(argv[++i]);
+      } else if (strcmp("-STEPK", argv[i]) == 0) {
+	STEPK = atoi(argv[++i]);
+      } else if (strcmp("-UN", argv[i]) == 0) {
+	uplo = 'u';
+	trans = 'n';
+      } else if (strcmp("-UT", argv[i]) == 0) {
+	uplo = 'u';
+	trans = 't';
+      } else if (strcmp("-LN", argv[i]) == 0) {
+	uplo = 'l';
+	trans = 'n';
+      } else if (strcmp("-LT", argv[i]) == 0) {
+	uplo = 'l';
+	trans = 't';
+      } else if (strcmp("-LOOP", argv[i]) == 0) {
+	LOOP = atoi(argv[++i]);
+      } else if (strcmp("-TOTALSTEPS", argv[i]) == 0) {
+	TOTALSTEPS = atoi(argv[++i]);
+      }
+    }
+  }
+
+  std::random_device seed_gen;
+  std::mt19937 engine(seed_gen());
+  std::uniform_real_distribution<> urdist(-1.0, 1.0);
+
+  n = N0;
+  k = K0;
+  for (p = 0; p < TOTALSTEPS; p++) {
+    if (Mlsame(&trans, "n")) {
+      ka = k;
+      lda = n;
+      ldb = n;
+    } else {
+      ka = n;
+      lda = k;
+      ldb = k;
+    }
+    ldc = n;
+
+    REAL *a = new REAL [lda * ka];
+    REAL *b = new REAL [ldb * ka];
+    REAL *c = new REAL [ldc * n];
+    alpha = urdist(engine);
+    beta = urdist(engine);
+    for (i = 0; i < lda * ka; i++) {
+      a[i] = urdist(engine);
+    }
+    for (i = 0; i < ldb * ka; i++) {
+      b[i] = urdist(engine);
+    }
+    for (i = 0; i < ldc * n; i++) {
+      c[i] = urdist(engine);
+    }
+    elapsedtime = 0.0;
+    for (int j = 0; j < LOOP; j++) {
+      std::chrono::steady_clock::time_point time_before;
+      std::chrono::steady_clock::time_point time_after;
+
+      time_before = std::chrono::steady_clock::now();
+      mpblas::Rsyr2k<REAL>(&uplo, &trans, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+      time_after = std::chrono::steady_clock::now();
+      double time_in_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before).count();
+
+      elapsedtime += time_in_ns;
+    }
+    elapsedtime = elapsedtime * NANOSECOND / (double)LOOP;
+    printf("    n     k     MFLOPS    uplo    trans\n");
+    printf("%5d %5d %10.3f       %c        %c\n", (int)n, (int)k, flops_syr2k(k, n) / elapsedtime * MFLOPS, uplo, trans);
+    delete[] c;
+    delete[] b;
+    delete[] a;
+    n = n + STEPN;
+    k = k + STEPK;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  bench<_Float16>(argc, argv);
+  bench<float>(argc, argv);
+  bench<double>(argc, argv);
+  bench<dd_real>(argc, argv);
+  bench<qd_real>(argc, argv);
+  bench<_Float128>(argc, argv);
+  bench<mpf_class>(argc, argv);
+}
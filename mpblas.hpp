@@ -27,5 +27,18 @@
  */
 
 #include "mpblas/Raxpy.hpp"
+#include "mpblas/Rgemv.hpp"
 #include "mpblas/Rgemm.hpp"
 #include "mpblas/Cgemm.hpp"
+#include "mpblas/Rgemm_batched.hpp"
+#include "mpblas/Cgemm_batched.hpp"
+#include "mpblas/Rgemm_fixed.hpp"
+#include "mpblas/Rsyrk.hpp"
+#include "mpblas/Rsyr2k.hpp"
+#include "mpblas/Rsymm.hpp"
+#if defined(_QD_DD_REAL_H) || defined(_QD_QD_REAL_H)
+#include "mpblas/qd.hpp"
+#endif
+#ifdef __GMP_PLUSPLUS__
+#include "mpblas/gmp.hpp"
+#endif
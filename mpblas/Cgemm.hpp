@@ -26,41 +26,168 @@
  *
  */
 
+#ifndef ___MPBLAS_CGEMM_H___
+#define ___MPBLAS_CGEMM_H___
+
 #include "Mlsame.hpp"
 #include "Mxerbla.hpp"
+#include "Mparallel.hpp"
+#include "Mtrans.hpp"
+#include "Mgemm_algo.hpp"
+#include "Mtypes.hpp"
+#include "Cgemm_3m.hpp"
+#include "Cgemm_blocked.hpp"
 #include <complex>
+#include <type_traits>
 
 namespace mpblas {
 
-template <typename REAL>
+//
+//     Hook for element types with their own implementation of the loops of
+//     Cgemm below (after argument checks, quick returns and the thread split).
+//     use(m, n, k) is true for the shapes these loops are meant for; Cgemm
+//     then takes neither the 3M nor the blocked path on its own.  run()
+//     returns false to fall back to the generic loops.
+//
+template <typename REAL> struct Cgemm_kernel {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static bool use(int64_t const, int64_t const, int64_t const) { return false; }
+    static bool run(bool const, bool const, bool const, bool const, int64_t const, int64_t const, int64_t const, std::complex<REAL> const &, std::complex<REAL> const *, int64_t const, std::complex<REAL> const *, int64_t const, std::complex<REAL> const &, std::complex<REAL> *, int64_t const) { return false; }
+};
 
-void Cgemm(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const alpha, std::complex<REAL> *a, int64_t const lda, std::complex<REAL> *b, int64_t const ldb, std::complex<REAL> const beta, std::complex<REAL> *c, int64_t const ldc) {
-    //
-    bool nota = Mlsame(transa, "N");
-    bool notb = Mlsame(transb, "N");
-    bool conja = Mlsame(transa, "C");
-    bool conjb = Mlsame(transb, "C");
-    int64_t nrowa = 0;
-    if (nota) {
-        nrowa = m;
+//
+//     The reference loops of Cgemm for one combination of op(A) = TA,
+//     op(B) = TB, alpha of class ALPHA (one or general) and beta of class
+//     BETA.  A unit alpha is not multiplied by, which only differs from the
+//     loops with the tests at run time in the sign of zero parts.
+//
+template <Mtrans TA, Mtrans TB, Mscalar ALPHA, Mscalar BETA, typename REAL> void Cgemm_loops(int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc) {
+    const std::complex<REAL> zero = std::complex<REAL>(0.0, 0.0);
+    auto opa = [](std::complex<REAL> const &x) {
+        if constexpr (TA == Mtrans::C) {
+            return std::conj(x);
+        } else {
+            return x;
+        }
+    };
+    auto opb = [](std::complex<REAL> const &x) {
+        if constexpr (TB == Mtrans::C) {
+            return std::conj(x);
+        } else {
+            return x;
+        }
+    };
+    int64_t i = 0;
+    int64_t j = 0;
+    int64_t l = 0;
+    std::complex<REAL> temp = std::complex<REAL>(0.0, 0.0);
+    if constexpr (TA == Mtrans::N) {
+        //
+        //        Form  C := alpha*A*op(B) + beta*C, one column at a time.
+        //
+        for (j = 0; j < n; j++) {
+            std::complex<REAL> *cj = &c[j * ldc];
+            if constexpr (BETA == Mscalar::zero) {
+                for (i = 0; i < m; i++) {
+                    cj[i] = zero;
+                }
+            } else if constexpr (BETA == Mscalar::general) {
+                for (i = 0; i < m; i++) {
+                    cj[i] = beta * cj[i];
+                }
+            }
+            for (l = 0; l < k; l++) {
+                if constexpr (ALPHA == Mscalar::one) {
+                    temp = opb((TB == Mtrans::N) ? b[l + j * ldb] : b[j + l * ldb]);
+                } else {
+                    temp = alpha * opb((TB == Mtrans::N) ? b[l + j * ldb] : b[j + l * ldb]);
+                }
+                std::complex<REAL> const *al = &a[l * lda];
+                for (i = 0; i < m; i++) {
+                    cj[i] += temp * al[i];
+                }
+            }
+        }
     } else {
-        nrowa = k;
+        //
+        //        Form  C := alpha*op(A)*op(B) + beta*C with op(A) = A**T or
+        //        A**H, one dot product per element.
+        //
+        for (j = 0; j < n; j++) {
+            for (i = 0; i < m; i++) {
+                std::complex<REAL> const *ai = &a[i * lda];
+                temp = zero;
+                if constexpr (TB == Mtrans::N) {
+                    std::complex<REAL> const *bj = &b[j * ldb];
+                    for (l = 0; l < k; l++) {
+                        temp += opa(ai[l]) * bj[l];
+                    }
+                } else {
+                    for (l = 0; l < k; l++) {
+                        temp += opa(ai[l]) * opb(b[j + l * ldb]);
+                    }
+                }
+                std::complex<REAL> &cij = c[i + j * ldc];
+                if constexpr (ALPHA == Mscalar::one && BETA == Mscalar::zero) {
+                    cij = temp;
+                } else if constexpr (ALPHA == Mscalar::one && BETA == Mscalar::one) {
+                    cij = temp + cij;
+                } else if constexpr (ALPHA == Mscalar::one) {
+                    cij = temp + beta * cij;
+                } else if constexpr (BETA == Mscalar::zero) {
+                    cij = alpha * temp;
+                } else if constexpr (BETA == Mscalar::one) {
+                    cij = alpha * temp + cij;
+                } else {
+                    cij = alpha * temp + beta * cij;
+                }
+            }
+        }
     }
-    int64_t nrowb = 0;
-    if (notb) {
-        nrowb = k;
+}
+
+//
+//     Cgemm_loops for the classes of alpha (nonzero) and beta.
+//
+template <Mtrans TA, Mtrans TB, typename REAL> void Cgemm_reference(int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc) {
+    const std::complex<REAL> zero = std::complex<REAL>(0.0, 0.0);
+    const std::complex<REAL> one = std::complex<REAL>(1.0, 0.0);
+    if (alpha == one) {
+        if (beta == zero) {
+            Cgemm_loops<TA, TB, Mscalar::one, Mscalar::zero>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else if (beta == one) {
+            Cgemm_loops<TA, TB, Mscalar::one, Mscalar::one>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else {
+            Cgemm_loops<TA, TB, Mscalar::one, Mscalar::general>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
     } else {
-        nrowb = n;
+        if (beta == zero) {
+            Cgemm_loops<TA, TB, Mscalar::general, Mscalar::zero>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else if (beta == one) {
+            Cgemm_loops<TA, TB, Mscalar::general, Mscalar::one>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else {
+            Cgemm_loops<TA, TB, Mscalar::general, Mscalar::general>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
     }
+}
+
+//
+//     Cgemm with the transpose modes as template parameters:
+//       Cgemm<Mtrans::N, Mtrans::C>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc)
+//     The other arguments and the error codes are those of Cgemm below.
+//
+template <Mtrans TA, Mtrans TB, typename REAL> void Cgemm(int64_t const m, int64_t const n, int64_t const k, std::type_identity_t<std::complex<REAL>> const &alpha, std::complex<REAL> *a, int64_t const lda, std::complex<REAL> *b, int64_t const ldb, std::type_identity_t<std::complex<REAL>> const &beta, std::complex<REAL> *c, int64_t const ldc, Mgemm_algo const algo = Mgemm_algo::automatic) {
+    constexpr bool nota = (TA == Mtrans::N);
+    constexpr bool notb = (TB == Mtrans::N);
+    constexpr bool conja = (TA == Mtrans::C);
+    constexpr bool conjb = (TB == Mtrans::C);
+    const int64_t nrowa = nota ? m : k;
+    const int64_t nrowb = notb ? k : n;
     //
     //     Test the input parameters.
     //
     int64_t info = 0;
-    if ((!nota) && (!conja) && (!Mlsame(transa, "T"))) {
-        info = 1;
-    } else if ((!notb) && (!conjb) && (!Mlsame(transb, "T"))) {
-        info = 2;
-    } else if (m < 0) {
+    if (m < 0) {
         info = 3;
     } else if (n < 0) {
         info = 4;
@@ -88,205 +215,108 @@ void Cgemm(const char *transa, const char *transb, int64_t const m, int64_t cons
     //
     //     And when  alpha.eq.zero.
     //
-    int64_t j = 0;
-    int64_t i = 0;
     if (alpha == zero) {
-        if (beta == zero) {
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    c[(i - 1) + (j - 1) * ldc] = zero;
-                }
-            }
-        } else {
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                }
+        Rgemm_scale(m, n, beta, zero, one, c, ldc);
+        return;
+    }
+    //
+    //     3M algorithm for expensive types, or on request.
+    //
+    const bool own = Cgemm_kernel<REAL>::use(m, n, k);
+    if ((algo == Mgemm_algo::gemm3m) || ((algo == Mgemm_algo::automatic) && !own && Cgemm_use_3m<REAL>(m, n, k))) {
+        Cgemm_3m(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    //
+    //     Planar packing onto the real blocked engine unless the problem is
+    //     tiny or for the loops of Cgemm_kernel.
+    //
+    if (!own && Cgemm_use_blocked<REAL>(m, n, k)) {
+        Cgemm_blocked(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    //
+    //     Split C into a 2-D grid of tiles, one per OpenMP thread.  Each tile
+    //     is an independent Cgemm on its rows of op(A) and columns of op(B),
+    //     so the result is bitwise identical to the serial one.
+    //
+    int64_t nthreads = std::min((int64_t)Mnum_threads(), m * n * k / 32768);
+    if (nthreads > 1) {
+        int64_t rsa = nota ? 1 : lda;
+        int64_t csb = notb ? ldb : 1;
+        int64_t tm = 1;
+        int64_t tn = 1;
+        Mtile_grid(m, n, 1, 1, nthreads, tm, tn);
+#pragma omp parallel for collapse(2) schedule(static) num_threads(tm * tn)
+        for (int64_t ti = 0; ti < tm; ti++) {
+            for (int64_t tj = 0; tj < tn; tj++) {
+                int64_t i0 = Mtile_start(ti, tm, m, 1);
+                int64_t i1 = Mtile_start(ti + 1, tm, m, 1);
+                int64_t j0 = Mtile_start(tj, tn, n, 1);
+                int64_t j1 = Mtile_start(tj + 1, tn, n, 1);
+                Cgemm<TA, TB>(i1 - i0, j1 - j0, k, alpha, &a[i0 * rsa], lda, &b[j0 * csb], ldb, beta, &c[i0 + j0 * ldc], ldc, algo);
             }
         }
         return;
     }
+    if (Cgemm_kernel<REAL>::run(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc)) {
+        return;
+    }
     //
     //     Start the operations.
     //
-    int64_t l = 0;
-    std::complex<REAL> temp = std::complex<REAL>(0.0, 0.0);
-    if (notb) {
-        if (nota) {
-            //
-            //           Form  C := alpha*A*B + beta*C.
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                if (beta == zero) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = zero;
-                    }
-                } else if (beta != one) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-                for (l = 1; l <= k; l = l + 1) {
-                    temp = alpha * b[(l - 1) + (j - 1) * ldb];
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] += temp * a[(i - 1) + (l - 1) * lda];
-                    }
-                }
-            }
-        } else if (conja) {
-            //
-            //           Form  C := alpha*A**H*B + beta*C.
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += std::conj(a[(l - 1) + (i - 1) * lda]) * b[(l - 1) + (j - 1) * ldb];
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
-        } else {
-            //
-            //           Form  C := alpha*A**T*B + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += a[(l - 1) + (i - 1) * lda] * b[(l - 1) + (j - 1) * ldb];
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
-        }
-    } else if (nota) {
-        if (conjb) {
-            //
-            //           Form  C := alpha*A*B**H + beta*C.
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                if (beta == zero) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = zero;
-                    }
-                } else if (beta != one) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-                for (l = 1; l <= k; l = l + 1) {
-                    temp = alpha * std::conj(b[(j - 1) + (l - 1) * ldb]);
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] += temp * a[(i - 1) + (l - 1) * lda];
-                    }
-                }
-            }
-        } else {
-            //
-            //           Form  C := alpha*A*B**T + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                if (beta == zero) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = zero;
-                    }
-                } else if (beta != one) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-                for (l = 1; l <= k; l = l + 1) {
-                    temp = alpha * b[(j - 1) + (l - 1) * ldb];
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] += temp * a[(i - 1) + (l - 1) * lda];
-                    }
-                }
-            }
-        }
-    } else if (conja) {
-        if (conjb) {
-            //
-            //           Form  C := alpha*A**H*B**H + beta*C.
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += std::conj(a[(l - 1) + (i - 1) * lda]) * std::conj(b[(j - 1) + (l - 1) * ldb]);
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
-        } else {
-            //
-            //           Form  C := alpha*A**H*B**T + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += std::conj(a[(l - 1) + (i - 1) * lda]) * b[(j - 1) + (l - 1) * ldb];
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
-        }
-    } else {
-        if (conjb) {
-            //
-            //           Form  C := alpha*A**T*B**H + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += a[(l - 1) + (i - 1) * lda] * std::conj(b[(j - 1) + (l - 1) * ldb]);
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
-        } else {
-            //
-            //           Form  C := alpha*A**T*B**T + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += a[(l - 1) + (i - 1) * lda] * b[(j - 1) + (l - 1) * ldb];
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
-        }
+    Cgemm_reference<TA, TB>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+//
+//     The typed Cgemm for op(A) = TA and op(B) = tb.
+//
+template <Mtrans TA, typename REAL> void Cgemm_trans(Mtrans const tb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> *a, int64_t const lda, std::complex<REAL> *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc, Mgemm_algo const algo) {
+    switch (tb) {
+    case Mtrans::N:
+        Cgemm<TA, Mtrans::N>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
+        break;
+    case Mtrans::T:
+        Cgemm<TA, Mtrans::T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
+        break;
+    case Mtrans::C:
+        Cgemm<TA, Mtrans::C>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
+        break;
+    }
+}
+
+template <typename REAL> void Cgemm(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const alpha, std::complex<REAL> *a, int64_t const lda, std::complex<REAL> *b, int64_t const ldb, std::complex<REAL> const beta, std::complex<REAL> *c, int64_t const ldc, Mgemm_algo const algo = Mgemm_algo::automatic) {
+    //
+    //     Test the input parameters.
+    //
+    Mtrans ta = Mtrans::N;
+    Mtrans tb = Mtrans::N;
+    if (!Mtrans_parse(transa, ta)) {
+        Mxerbla("Cgemm ", 1);
+        return;
+    }
+    if (!Mtrans_parse(transb, tb)) {
+        Mxerbla("Cgemm ", 2);
+        return;
+    }
+    //
+    //     The rest is done by the typed Cgemm.
+    //
+    switch (ta) {
+    case Mtrans::N:
+        Cgemm_trans<Mtrans::N>(tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
+        break;
+    case Mtrans::T:
+        Cgemm_trans<Mtrans::T>(tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
+        break;
+    case Mtrans::C:
+        Cgemm_trans<Mtrans::C>(tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
+        break;
     }
     //
     //     End of Cgemm .
     //
 }
 }
+
+#endif
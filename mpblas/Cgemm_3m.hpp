@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Cgemm by the 3M method: with op(A) = Ar + i Ai and op(B) = Br + i Bi,
+    P1 = Ar Br,  P2 = Ai Bi,  P3 = (Ar + Ai) (Br + Bi),
+    op(A) op(B) = (P1 - P2) + i (P3 - P1 - P2),
+i.e. three real GEMMs (on Rgemm, with all of its algorithms) instead of four,
+at the price of O(mk + kn + mn) real additions.  conj() is folded into the
+sign of Ai and Bi while the real and imaginary parts are split.
+The imaginary part satisfies a normwise rather than an elementwise error
+bound; Mgemm_algo::classical turns the method off.
+*/
+
+#ifndef ___MPBLAS_CGEMM_3M_H___
+#define ___MPBLAS_CGEMM_3M_H___
+
+#include <algorithm>
+#include <complex>
+#include "Mbuffer.hpp"
+#include "Mtypes.hpp"
+#include "Rgemm.hpp"
+
+namespace mpblas {
+
+//
+//     Whether Mgemm_algo::automatic uses 3M: only where a real multiplication
+//     costs much more than an addition.
+//
+template <typename REAL> struct Cgemm_3m_traits {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static constexpr bool automatic = false;
+};
+
+#ifdef __FLT128_MANT_DIG__
+template <> struct Cgemm_3m_traits<_Float128> {
+    static constexpr bool automatic = true;
+};
+#endif
+
+//
+//     Below 16 in any dimension the splitting costs about as much as the
+//     multiplication it saves.
+//
+template <typename REAL> bool Cgemm_use_3m(int64_t const m, int64_t const n, int64_t const k) { return Cgemm_3m_traits<REAL>::automatic && (std::min(std::min(m, n), k) >= 16); }
+
+template <typename REAL> void Cgemm_3m(bool const nota, bool const conja, bool const notb, bool const conjb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc) {
+    const REAL rzero = 0.0;
+    const REAL rone = 1.0;
+    const std::complex<REAL> zero = std::complex<REAL>(0.0, 0.0);
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csa = nota ? lda : 1;
+    const int64_t rsb = notb ? 1 : ldb;
+    const int64_t csb = notb ? ldb : 1;
+    //
+    //     Ar, Ai, Ar + Ai (m x k), Br, Bi, Br + Bi (k x n) and P1, P2, P3
+    //     (m x n), all column major.
+    //
+    thread_local Mbuffer<REAL> buffer;
+    REAL *ar = buffer.reserve(3 * m * k + 3 * k * n + 3 * m * n);
+    REAL *ai = ar + m * k;
+    REAL *as = ai + m * k;
+    REAL *br = as + m * k;
+    REAL *bi = br + k * n;
+    REAL *bs = bi + k * n;
+    REAL *p1 = bs + k * n;
+    REAL *p2 = p1 + m * n;
+    REAL *p3 = p2 + m * n;
+    for (int64_t l = 0; l < k; l++) {
+        for (int64_t i = 0; i < m; i++) {
+            std::complex<REAL> const &z = a[i * rsa + l * csa];
+            ar[i + l * m] = z.real();
+            ai[i + l * m] = conja ? REAL(-z.imag()) : z.imag();
+            as[i + l * m] = ar[i + l * m] + ai[i + l * m];
+        }
+    }
+    for (int64_t j = 0; j < n; j++) {
+        for (int64_t l = 0; l < k; l++) {
+            std::complex<REAL> const &z = b[l * rsb + j * csb];
+            br[l + j * k] = z.real();
+            bi[l + j * k] = conjb ? REAL(-z.imag()) : z.imag();
+            bs[l + j * k] = br[l + j * k] + bi[l + j * k];
+        }
+    }
+    const int64_t ldk = std::max((int64_t)1, k);
+    Rgemm("N", "N", m, n, k, rone, ar, m, br, ldk, rzero, p1, m);
+    Rgemm("N", "N", m, n, k, rone, ai, m, bi, ldk, rzero, p2, m);
+    Rgemm("N", "N", m, n, k, rone, as, m, bs, ldk, rzero, p3, m);
+    //
+    //     C := alpha * (P1 - P2 + i (P3 - P1 - P2)) + beta * C; C is not read
+    //     when beta is zero.
+    //
+    const bool betazero = (beta == zero);
+    for (int64_t j = 0; j < n; j++) {
+        for (int64_t i = 0; i < m; i++) {
+            const int64_t p = i + j * m;
+            std::complex<REAL> t(p1[p] - p2[p], p3[p] - p1[p] - p2[p]);
+            if (betazero) {
+                c[i + j * ldc] = alpha * t;
+            } else {
+                c[i + j * ldc] = alpha * t + beta * c[i + j * ldc];
+            }
+        }
+    }
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Batched Cgemm: C_p := alpha*op(A_p)*op(B_p) + beta*C_p for p = 0..batch_count-1,
+all products of the same shape.
+  Cgemm_batched          A_p = a[p], B_p = b[p], C_p = c[p]
+  Cgemm_strided_batched  A_p = a + p*stridea, B_p = b + p*strideb, C_p = c + p*stridec
+The batch is validated and distributed over the OpenMP threads by
+Mbatched.hpp, as for Rgemm_batched.hpp; the products run on the planar engine
+of Cgemm_blocked.hpp.
+*/
+
+#ifndef ___MPBLAS_CGEMM_BATCHED_H___
+#define ___MPBLAS_CGEMM_BATCHED_H___
+
+#include "Mxerbla.hpp"
+#include "Mbatched.hpp"
+#include "Cgemm_blocked.hpp"
+#include <complex>
+
+namespace mpblas {
+
+//
+//     The products of a validated batch; operands(p, a, b, c) sets the
+//     matrices of product p.
+//
+template <typename REAL, typename OPERANDS> void Cgemm_batch(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, int64_t const lda, int64_t const ldb, std::complex<REAL> const &beta, int64_t const ldc, int64_t const batch_count, OPERANDS const &operands) {
+    bool nota = Mlsame(transa, "N");
+    bool notb = Mlsame(transb, "N");
+    bool conja = Mlsame(transa, "C");
+    bool conjb = Mlsame(transb, "C");
+    const std::complex<REAL> zero = std::complex<REAL>(0.0, 0.0);
+    const std::complex<REAL> one = std::complex<REAL>(1.0, 0.0);
+    Mbatch(m, n, k, alpha, beta, zero, one, ldc, batch_count, operands, [&](bool const threaded, std::complex<REAL> *a, std::complex<REAL> *b, std::complex<REAL> *c) {
+        if (threaded) {
+            Cgemm_blocked(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else {
+            Cgemm_update(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, zero, one, c, ldc);
+        }
+    });
+}
+
+template <typename REAL> void Cgemm_batched(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> **a, int64_t const lda, std::complex<REAL> **b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> **c, int64_t const ldc, int64_t const batch_count) {
+    int64_t info = Mbatched_info(transa, transb, m, n, k, lda, ldb, ldc, batch_count, false, 0, 0, 0);
+    if (info != 0) {
+        Mxerbla("Cgemm_batched ", info);
+        return;
+    }
+    Cgemm_batch(transa, transb, m, n, k, alpha, lda, ldb, beta, ldc, batch_count, [&](int64_t const p, std::complex<REAL> *&ap, std::complex<REAL> *&bp, std::complex<REAL> *&cp) {
+        ap = a[p];
+        bp = b[p];
+        cp = c[p];
+    });
+}
+
+//
+//     stridea and strideb may be zero to use one A or B for the whole batch;
+//     the C_p must not overlap: stridec >= ldc*(n-1) + m.
+//
+template <typename REAL> void Cgemm_strided_batched(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> *a, int64_t const lda, int64_t const stridea, std::complex<REAL> *b, int64_t const ldb, int64_t const strideb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc, int64_t const stridec, int64_t const batch_count) {
+    int64_t info = Mbatched_info(transa, transb, m, n, k, lda, ldb, ldc, batch_count, true, stridea, strideb, stridec);
+    if (info != 0) {
+        Mxerbla("Cgemm_strided_batched ", info);
+        return;
+    }
+    Cgemm_batch(transa, transb, m, n, k, alpha, lda, ldb, beta, ldc, batch_count, [&](int64_t const p, std::complex<REAL> *&ap, std::complex<REAL> *&bp, std::complex<REAL> *&cp) {
+        ap = a + p * stridea;
+        bp = b + p * strideb;
+        cp = c + p * stridec;
+    });
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Planar complex GEMM on the real blocked engine.
+op(A) and op(B) are packed into separate real and imaginary panels with the
+packing routines of Rgemm_kernel<REAL> (an interleaved std::complex<REAL>
+array is a REAL array with stride 2), and each register tile of C is formed
+by four real micro-kernel calls,
+    Re C += ar * (Ar Br - sa sb Ai Bi),   Im C += ar * (sb Ar Bi + sa Ai Br),
+where sa (sb) is -1 when op(A) (op(B)) conjugates.  Conjugation and a real
+alpha are thus folded into the kernels' alpha and cost nothing; a complex
+alpha is applied once per tile.  beta is applied as the tiles of the first KC
+slice are loaded from or stored to C, which is not read when beta is zero.
+Every optimization of the real path (SIMD, split limbs, raw GMP) carries over
+to Cgemm.
+*/
+
+#ifndef ___MPBLAS_CGEMM_BLOCKED_H___
+#define ___MPBLAS_CGEMM_BLOCKED_H___
+
+#include <algorithm>
+#include <complex>
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+template <typename REAL> bool Cgemm_use_blocked(int64_t const m, int64_t const n, int64_t const k) { return Rgemm_use_blocked<REAL>(m, n, k); }
+
+//
+//     C := alpha*op(A)*op(B) + beta*C on the calling thread.  The arguments
+//     are those of Cgemm after validation; zero and one are supplied by the
+//     caller, as for Rgemm_update.
+//
+template <typename REAL> void Cgemm_update(bool const nota, bool const conja, bool const notb, bool const conjb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> const &zero, std::complex<REAL> const &one, std::complex<REAL> *c, int64_t const ldc) {
+    if ((m == 0) || (n == 0)) {
+        return;
+    }
+    if (k == 0) {
+        Rgemm_scale(m, n, beta, zero, one, c, ldc);
+        return;
+    }
+    int64_t i = 0;
+    int64_t j = 0;
+    //
+    //     op(A), op(B) and C as REAL arrays: the real part of an element is at
+    //     an even offset, the imaginary part right after it.
+    //
+    REAL const *ar = reinterpret_cast<REAL const *>(a);
+    REAL const *br = reinterpret_cast<REAL const *>(b);
+    REAL *cr = reinterpret_cast<REAL *>(c);
+    const int64_t rsa = nota ? 2 : 2 * lda;
+    const int64_t csa = nota ? 2 * lda : 2;
+    const int64_t rsb = notb ? 2 : 2 * ldb;
+    const int64_t csb = notb ? 2 * ldb : 2;
+    //
+    //     Kernel alphas of Ar Br, Ai Bi, Ar Bi and Ai Br.
+    //
+    const REAL rzero = 0.0;
+    const REAL rone = 1.0;
+    const bool realalpha = (alpha.imag() == rzero);
+    const REAL s = realalpha ? REAL(alpha.real()) : rone;
+    const REAL w_rr = s;
+    const REAL w_ii = (conja == conjb) ? REAL(-s) : s;
+    const REAL w_ri = conjb ? REAL(-s) : s;
+    const REAL w_ir = conja ? REAL(-s) : s;
+    const REAL alr = alpha.real();
+    const REAL ali = alpha.imag();
+    const bool betazero = (beta == zero);
+    const bool betaone = (beta == one);
+    //
+    //     The panels hold twice as many elements as in Rgemm_packed, so MC
+    //     and NC are halved to keep the same cache footprint.
+    //
+    const int64_t mr = Rgemm_kernel<REAL>::mr();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    int64_t MC = 0;
+    int64_t KC = 0;
+    int64_t NC = 0;
+    Rgemm_blocks<REAL>(mr, nr, MC, KC, NC);
+    MC = std::max(mr, (MC / 2 + mr - 1) / mr * mr);
+    NC = std::max(nr, (NC / 2 + nr - 1) / nr * nr);
+    const int64_t mcmax = std::min(MC, (m + mr - 1) / mr * mr);
+    const int64_t ncmax = std::min(NC, (n + nr - 1) / nr * nr);
+    const int64_t kcmax = std::min(KC, k);
+    const int64_t ps = Rgemm_kernel<REAL>::packed_size;
+    typedef typename Rgemm_kernel<REAL>::packed_t PACKED;
+    Rgemm_workspace<PACKED> &work = Rgemm_workspace<PACKED>::local();
+    PACKED *apr = work.apack.reserve(2 * mcmax * kcmax * ps);
+    PACKED *api = apr + mcmax * kcmax * ps;
+    PACKED *bpr = work.bpack.reserve(2 * kcmax * ncmax * ps);
+    PACKED *bpi = bpr + kcmax * ncmax * ps;
+    //
+    //     Real and imaginary part of one register tile of C, column major.
+    //
+    thread_local Mbuffer<REAL> tile;
+    REAL *tr = tile.reserve(2 * mr * nr);
+    REAL *ti = tr + mr * nr;
+    for (int64_t jc = 0; jc < n; jc += NC) {
+        int64_t nc = std::min(NC, n - jc);
+        for (int64_t pc = 0; pc < k; pc += KC) {
+            int64_t kc = std::min(KC, k - pc);
+            const bool first = (pc == 0);
+            //
+            //     With a real alpha the tile starts from C (times beta in the
+            //     first slice) unless that is zero; the first kernel call on
+            //     each part then overwrites the tile instead of adding to it.
+            //
+            const bool fromc = realalpha && !(first && betazero);
+            const REAL &wfirst = fromc ? rone : rzero;
+            Rgemm_kernel<REAL>::pack_b(kc, nc, &br[pc * rsb + jc * csb], rsb, csb, nr, bpr);
+            Rgemm_kernel<REAL>::pack_b(kc, nc, &br[pc * rsb + jc * csb + 1], rsb, csb, nr, bpi);
+            for (int64_t ic = 0; ic < m; ic += MC) {
+                int64_t mc = std::min(MC, m - ic);
+                Rgemm_kernel<REAL>::pack_a(mc, kc, &ar[ic * rsa + pc * csa], rsa, csa, mr, apr);
+                Rgemm_kernel<REAL>::pack_a(mc, kc, &ar[ic * rsa + pc * csa + 1], rsa, csa, mr, api);
+                for (int64_t jr = 0; jr < nc; jr += nr) {
+                    for (int64_t ir = 0; ir < mc; ir += mr) {
+                        const int64_t mb = std::min(mr, mc - ir);
+                        const int64_t nb = std::min(nr, nc - jr);
+                        REAL *ct = &cr[2 * ((ic + ir) + (jc + jr) * ldc)];
+                        //
+                        //     With a real alpha the tile is stored back to C;
+                        //     otherwise alpha times it is added to C, or to
+                        //     beta*C in the first slice.
+                        //
+                        if (fromc) {
+                            for (j = 0; j < nb; j++) {
+                                for (i = 0; i < mb; i++) {
+                                    if (first && !betaone) {
+                                        const std::complex<REAL> x = beta * c[(ic + ir + i) + (jc + jr + j) * ldc];
+                                        tr[i + j * mr] = x.real();
+                                        ti[i + j * mr] = x.imag();
+                                    } else {
+                                        tr[i + j * mr] = ct[2 * (i + j * ldc)];
+                                        ti[i + j * mr] = ct[2 * (i + j * ldc) + 1];
+                                    }
+                                }
+                            }
+                        }
+                        PACKED const *a_r = &apr[ir * kc * ps];
+                        PACKED const *a_i = &api[ir * kc * ps];
+                        PACKED const *b_r = &bpr[jr * kc * ps];
+                        PACKED const *b_i = &bpi[jr * kc * ps];
+                        Rgemm_kernel<REAL>::run(kc, w_rr, a_r, b_r, wfirst, tr, mr, mb, nb);
+                        Rgemm_kernel<REAL>::run(kc, w_ii, a_i, b_i, rone, tr, mr, mb, nb);
+                        Rgemm_kernel<REAL>::run(kc, w_ri, a_r, b_i, wfirst, ti, mr, mb, nb);
+                        Rgemm_kernel<REAL>::run(kc, w_ir, a_i, b_r, rone, ti, mr, mb, nb);
+                        for (j = 0; j < nb; j++) {
+                            for (i = 0; i < mb; i++) {
+                                REAL &cre = ct[2 * (i + j * ldc)];
+                                REAL &cim = ct[2 * (i + j * ldc) + 1];
+                                if (realalpha) {
+                                    cre = tr[i + j * mr];
+                                    cim = ti[i + j * mr];
+                                } else if (first && betazero) {
+                                    cre = alr * tr[i + j * mr] - ali * ti[i + j * mr];
+                                    cim = alr * ti[i + j * mr] + ali * tr[i + j * mr];
+                                } else if (first && !betaone) {
+                                    std::complex<REAL> &cij = c[(ic + ir + i) + (jc + jr + j) * ldc];
+                                    cij = beta * cij + std::complex<REAL>(alr * tr[i + j * mr] - ali * ti[i + j * mr], alr * ti[i + j * mr] + ali * tr[i + j * mr]);
+                                } else {
+                                    cre += alr * tr[i + j * mr] - ali * ti[i + j * mr];
+                                    cim += alr * ti[i + j * mr] + ali * tr[i + j * mr];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename REAL> void Cgemm_update(bool const nota, bool const conja, bool const notb, bool const conjb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc) {
+    const std::complex<REAL> zero = std::complex<REAL>(0.0, 0.0);
+    const std::complex<REAL> one = std::complex<REAL>(1.0, 0.0);
+    Cgemm_update(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, zero, one, c, ldc);
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C on the calling thread.
+//
+template <typename REAL> void Cgemm_packed(bool const nota, bool const conja, bool const notb, bool const conjb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc) {
+    Cgemm_update(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C by Cgemm_packed, on a 2-D grid of tiles
+//     of C aligned to the register tile, one or Rgemm_tasks_per_thread per
+//     OpenMP thread, as in Rgemm_blocked.
+//
+template <typename REAL> void Cgemm_blocked(bool const nota, bool const conja, bool const notb, bool const conjb, int64_t const m, int64_t const n, int64_t const k, std::complex<REAL> const &alpha, std::complex<REAL> const *a, int64_t const lda, std::complex<REAL> const *b, int64_t const ldb, std::complex<REAL> const &beta, std::complex<REAL> *c, int64_t const ldc) {
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), 4 * m * n * std::max(k, (int64_t)1) / Rgemm_blocking<REAL>::work_per_thread);
+    if (nthreads <= 1) {
+        Cgemm_packed(nota, conja, notb, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csb = notb ? ldb : 1;
+    const int64_t mr = Rgemm_kernel<REAL>::mr();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    Mparallel_tiles(m, n, mr, nr, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1) { Cgemm_packed(nota, conja, notb, conjb, i1 - i0, j1 - j0, k, alpha, &a[i0 * rsa], lda, &b[j0 * csb], ldb, beta, &c[i0 + j0 * ldc], ldc); }, Rgemm_tasks_per_thread<REAL>());
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Cgemm for std::complex<mpf_class> on the raw GMP API.
+The complex products of the generic loops build several gmpxx temporaries
+(mpf_init/mpf_clear) per multiply-add; here the real and imaginary parts are
+accumulated in per-thread mpf_t scratch with mpf_mul/mpf_add/mpf_sub, so the
+inner loops allocate nothing.  conj() is folded into the sign of the update.
+Without the packing of the 3M and blocked paths these loops are the fastest
+for small products and short sums, so Cgemm sends them here: fewer than
+small_work multiply-adds, or k below short_k (measured at 256 bits).
+This header is included by gmp.hpp.
+*/
+
+#ifndef ___MPBLAS_CGEMM_MPF_H___
+#define ___MPBLAS_CGEMM_MPF_H___
+
+#include <complex>
+#include <gmpxx.h>
+#include "Cgemm.hpp"
+#include "Rgemm_mpf.hpp"
+
+namespace mpblas {
+
+//
+//     Real and imaginary part of z in place.  std::complex<T>::real() returns
+//     a copy; std::complex<T> is laid out as T[2] by libstdc++ and libc++.
+//
+inline mpf_srcptr Cgemm_mpf_re(std::complex<mpf_class> const &z) { return reinterpret_cast<mpf_class const *>(&z)[0].get_mpf_t(); }
+inline mpf_srcptr Cgemm_mpf_im(std::complex<mpf_class> const &z) { return reinterpret_cast<mpf_class const *>(&z)[1].get_mpf_t(); }
+inline mpf_ptr Cgemm_mpf_re(std::complex<mpf_class> &z) { return reinterpret_cast<mpf_class *>(&z)[0].get_mpf_t(); }
+inline mpf_ptr Cgemm_mpf_im(std::complex<mpf_class> &z) { return reinterpret_cast<mpf_class *>(&z)[1].get_mpf_t(); }
+
+//
+//     (sr, si) += op(x) * op(y), where op conjugates when cx (cy) is set.
+//
+inline void Cgemm_mpf_madd(mpf_ptr sr, mpf_ptr si, mpf_ptr tmp, std::complex<mpf_class> const &x, bool const cx, std::complex<mpf_class> const &y, bool const cy) {
+    mpf_srcptr xr = Cgemm_mpf_re(x);
+    mpf_srcptr xi = Cgemm_mpf_im(x);
+    mpf_srcptr yr = Cgemm_mpf_re(y);
+    mpf_srcptr yi = Cgemm_mpf_im(y);
+    mpf_mul(tmp, xr, yr);
+    mpf_add(sr, sr, tmp);
+    mpf_mul(tmp, xi, yi);
+    if (cx == cy) {
+        mpf_sub(sr, sr, tmp);
+    } else {
+        mpf_add(sr, sr, tmp);
+    }
+    mpf_mul(tmp, xr, yi);
+    if (cy) {
+        mpf_sub(si, si, tmp);
+    } else {
+        mpf_add(si, si, tmp);
+    }
+    mpf_mul(tmp, xi, yr);
+    if (cx) {
+        mpf_sub(si, si, tmp);
+    } else {
+        mpf_add(si, si, tmp);
+    }
+}
+
+template <> struct Cgemm_kernel<mpf_class> {
+    static constexpr int64_t small_work = 32768;
+    static constexpr int64_t short_k = 12;
+    static bool use(int64_t const m, int64_t const n, int64_t const k) { return (m * n * k < small_work) || (k < short_k); }
+    static bool run(bool const nota, bool const conja, bool const notb, bool const conjb, int64_t const m, int64_t const n, int64_t const k, std::complex<mpf_class> const &alpha, std::complex<mpf_class> const *a, int64_t const lda, std::complex<mpf_class> const *b, int64_t const ldb, std::complex<mpf_class> const &beta, std::complex<mpf_class> *c, int64_t const ldc) {
+        const int64_t rsa = nota ? 1 : lda;
+        const int64_t csa = nota ? lda : 1;
+        const int64_t rsb = notb ? 1 : ldb;
+        const int64_t csb = notb ? ldb : 1;
+        const bool betazero = (beta == std::complex<mpf_class>(0.0, 0.0));
+        //
+        //     One column of accumulators (re, im) and three temporaries.
+        //
+        mpf_ptr s = Mmpf_scratch::local().get(2 * m + 3);
+        mpf_ptr t = &s[2 * m];
+        mpf_ptr u = &s[2 * m + 1];
+        mpf_ptr v = &s[2 * m + 2];
+        for (int64_t j = 0; j < n; j++) {
+            for (int64_t i = 0; i < 2 * m; i++) {
+                mpf_set_ui(&s[i], 0);
+            }
+            //
+            //     Every sum runs over l in increasing order; the loop order
+            //     only follows the contiguous direction of op(A).
+            //
+            if (nota) {
+                for (int64_t l = 0; l < k; l++) {
+                    std::complex<mpf_class> const &blj = b[l * rsb + j * csb];
+                    for (int64_t i = 0; i < m; i++) {
+                        Cgemm_mpf_madd(&s[2 * i], &s[2 * i + 1], t, a[i * rsa + l * csa], conja, blj, conjb);
+                    }
+                }
+            } else {
+                for (int64_t i = 0; i < m; i++) {
+                    for (int64_t l = 0; l < k; l++) {
+                        Cgemm_mpf_madd(&s[2 * i], &s[2 * i + 1], t, a[i * rsa + l * csa], conja, b[l * rsb + j * csb], conjb);
+                    }
+                }
+            }
+            //
+            //     C(:, j) := alpha * s + beta * C(:, j); C is not read when
+            //     beta is zero.
+            //
+            for (int64_t i = 0; i < m; i++) {
+                mpf_ptr sr = &s[2 * i];
+                mpf_ptr si = &s[2 * i + 1];
+                mpf_ptr cr = Cgemm_mpf_re(c[i + j * ldc]);
+                mpf_ptr ci = Cgemm_mpf_im(c[i + j * ldc]);
+                mpf_mul(t, Cgemm_mpf_re(alpha), sr);
+                mpf_mul(u, Cgemm_mpf_im(alpha), si);
+                mpf_sub(t, t, u);
+                mpf_mul(u, Cgemm_mpf_re(alpha), si);
+                mpf_mul(v, Cgemm_mpf_im(alpha), sr);
+                mpf_add(u, u, v);
+                if (betazero) {
+                    mpf_set(cr, t);
+                    mpf_set(ci, u);
+                } else {
+                    mpf_mul(sr, Cgemm_mpf_re(beta), cr);
+                    mpf_mul(v, Cgemm_mpf_im(beta), ci);
+                    mpf_sub(sr, sr, v);
+                    mpf_mul(si, Cgemm_mpf_re(beta), ci);
+                    mpf_mul(v, Cgemm_mpf_im(beta), cr);
+                    mpf_add(si, si, v);
+                    mpf_add(cr, t, sr);
+                    mpf_add(ci, u, si);
+                }
+            }
+        }
+        return true;
+    }
+};
+} // namespace mpblas
+
+#endif
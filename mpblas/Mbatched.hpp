@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Shared part of the batched products (Rgemm_batched.hpp, Cgemm_batched.hpp).
+Mbatched_info tests the arguments of a batch, with the numbering of
+Rgemm_batched (strided == false) or Rgemm_strided_batched (strided == true).
+Mbatch runs the products of a validated batch: alpha and beta are compared
+against zero and one once for the whole batch.  When there are at least as
+many products as threads, each product is computed by one OpenMP thread with
+that thread's packing buffers, the products being handed out by the
+work-stealing scheduler of Mscheduler.hpp; otherwise the products are
+computed one after another, each with all threads.
+*/
+
+#ifndef ___MPBLAS_MBATCHED_H___
+#define ___MPBLAS_MBATCHED_H___
+
+#include "Mlsame.hpp"
+#include "Mparallel.hpp"
+#include "Rgemm_blocked.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace mpblas {
+
+inline int64_t Mbatched_info(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, int64_t const lda, int64_t const ldb, int64_t const ldc, int64_t const batch_count, bool const strided, int64_t const stridea, int64_t const strideb, int64_t const stridec) {
+    bool nota = Mlsame(transa, "N");
+    bool notb = Mlsame(transb, "N");
+    int64_t nrowa = nota ? m : k;
+    int64_t nrowb = notb ? k : n;
+    //
+    //     The strided form has a stride after each of A, B and C.
+    //
+    int64_t s = strided ? 1 : 0;
+    if ((!nota) && (!Mlsame(transa, "C")) && (!Mlsame(transa, "T"))) {
+        return 1;
+    } else if ((!notb) && (!Mlsame(transb, "C")) && (!Mlsame(transb, "T"))) {
+        return 2;
+    } else if (m < 0) {
+        return 3;
+    } else if (n < 0) {
+        return 4;
+    } else if (k < 0) {
+        return 5;
+    } else if (lda < std::max((int64_t)1, nrowa)) {
+        return 8;
+    } else if (strided && (stridea < 0)) {
+        return 9;
+    } else if (ldb < std::max((int64_t)1, nrowb)) {
+        return 10 + s;
+    } else if (strided && (strideb < 0)) {
+        return 12;
+    } else if (ldc < std::max((int64_t)1, m)) {
+        return 13 + 2 * s;
+    } else if (strided && (batch_count > 1) && (m > 0) && (n > 0) && (stridec < ldc * (n - 1) + m)) {
+        return 16;
+    } else if (batch_count < 0) {
+        return 14 + 3 * s;
+    }
+    return 0;
+}
+
+//
+//     The products of a validated batch.  operands(p, a, b, c) sets the
+//     matrices of product p; product(threaded, a, b, c) computes one product
+//     with alpha nonzero, on all threads when threaded is set and on the
+//     calling thread otherwise.  Products with alpha zero only scale C.
+//
+template <typename T, typename OPERANDS, typename PRODUCT> void Mbatch(int64_t const m, int64_t const n, int64_t const k, T const &alpha, T const &beta, T const &zero, T const &one, int64_t const ldc, int64_t const batch_count, OPERANDS const &operands, PRODUCT const &product) {
+    if ((m == 0) || (n == 0) || (batch_count == 0) || (((alpha == zero) || (k == 0)) && (beta == one))) {
+        return;
+    }
+    const bool update = (alpha != zero);
+    const int64_t nthreads = Mnum_threads();
+    if (batch_count < nthreads) {
+        for (int64_t p = 0; p < batch_count; p++) {
+            T *a = nullptr;
+            T *b = nullptr;
+            T *c = nullptr;
+            operands(p, a, b, c);
+            if (update) {
+                product(true, a, b, c);
+            } else {
+                Rgemm_scale(m, n, beta, zero, one, c, ldc);
+            }
+        }
+        return;
+    }
+    Mparallel_tasks(batch_count, nthreads, [&](int64_t const p) {
+        T *a = nullptr;
+        T *b = nullptr;
+        T *c = nullptr;
+        operands(p, a, b, c);
+        if (update) {
+            product(false, a, b, c);
+        } else {
+            Rgemm_scale(m, n, beta, zero, one, c, ldc);
+        }
+    });
+}
+} // namespace mpblas
+
+#endif
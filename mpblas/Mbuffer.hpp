@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Per-thread buffers that are kept from call to call, so that repeated calls
+neither allocate nor construct multiprecision elements again.  A buffer is
+rebuilt when its thread has moved to another NUMA node (Mnuma.hpp), so that
+its pages are first touched on the node that uses them.
+*/
+
+#ifndef ___MPBLAS_MBUFFER_H___
+#define ___MPBLAS_MBUFFER_H___
+
+#include <cstdint>
+#include <vector>
+#include "Mnuma.hpp"
+#include "Mtypes.hpp"
+
+namespace mpblas {
+
+//
+//     Format of the elements of type T a buffer was built for.  Only types
+//     with a run-time precision (mpf_class, see Rgemm_mpf.hpp) have more
+//     than one.
+//
+template <typename T> struct Mbuffer_format {
+    static_assert(Mtype_ready<T>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static uint64_t current() { return 0; }
+};
+
+//
+//     A growable array of T; it is rebuilt when the element format or the
+//     NUMA node of the thread changes.  The pointer returned by reserve()
+//     stays valid until the next reserve().
+//
+template <typename T> struct Mbuffer {
+    std::vector<T> v;
+    uint64_t format = 0;
+    int node = 0;
+    T *reserve(int64_t const size) {
+        if (node != Mnuma_local_node()) {
+            std::vector<T>().swap(v);
+            node = Mnuma_local_node();
+        }
+        if (format != Mbuffer_format<T>::current()) {
+            v.clear();
+            format = Mbuffer_format<T>::current();
+        }
+        if ((int64_t)v.size() < size) {
+            v.resize(size);
+        }
+        return v.data();
+    }
+};
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Copies between a strided vector and a contiguous buffer, for the routines
+whose unit-stride loops are faster than their strided ones.  The vector has
+n elements and increment inc; as in the reference BLAS, element i is at
+v[i * inc] when inc > 0 and at v[(n - 1 - i) * -inc] when inc < 0, i.e. the
+loops start at kx = -(n - 1) * incx (ix = (-n + 1) * incx + 1 counting from
+one).  The buffer holds the elements in the order i = 0, ..., n - 1.
+*/
+
+#ifndef ___MPBLAS_MGATHER_H___
+#define ___MPBLAS_MGATHER_H___
+
+#include <cstdint>
+
+namespace mpblas {
+
+//
+//     w(i) := v(i), i = 0, ..., n - 1.
+//
+template <typename REAL> void Mgather(int64_t const n, REAL const *v, int64_t const inc, REAL *w) {
+    int64_t iv = (inc > 0) ? 0 : -(n - 1) * inc;
+    for (int64_t i = 0; i < n; i++) {
+        w[i] = v[iv];
+        iv += inc;
+    }
+}
+
+//
+//     v(i) := w(i), i = 0, ..., n - 1.
+//
+template <typename REAL> void Mscatter(int64_t const n, REAL const *w, REAL *v, int64_t const inc) {
+    int64_t iv = (inc > 0) ? 0 : -(n - 1) * inc;
+    for (int64_t i = 0; i < n; i++) {
+        v[iv] = w[i];
+        iv += inc;
+    }
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef ___MPBLAS_MGEMM_ALGO_H___
+#define ___MPBLAS_MGEMM_ALGO_H___
+
+namespace mpblas {
+
+//
+//     Algorithm for Rgemm and Cgemm (last, optional argument).  automatic lets the
+//     routine choose; any other value forces that method where the element
+//     type supports it, and is ignored otherwise.
+//       classical  the blocked engine / the reference loops
+//       ozaki      error-free splitting into double GEMMs (Rgemm_ozaki.hpp)
+//       strassen   Strassen-Winograd recursion (Rgemm_strassen.hpp)
+//       gemm3m     Cgemm from three real products (Cgemm_3m.hpp)
+//       recursive  cache-oblivious recursion, no blocking parameters
+//                  (Rgemm_recursive.hpp)
+//       morton     the same on Morton-ordered tiled copies of the operands
+//       ksplit     the blocked engine with k split across threads
+//                  (Rgemm_ksplit.hpp)
+//
+enum class Mgemm_algo { automatic, classical, ozaki, strassen, gemm3m, recursive, morton, ksplit };
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+NUMA support for the parallel paths.
+In NUMA mode (Mnuma_mode(); initially on when the environment variable
+MPBLAS_NUMA is set to a nonzero value) the threads of a product fill as few
+NUMA nodes as hold them, in blocks: threads 0..p-1 on the first node,
+p..2p-1 on the second and so on, each pinned to a CPU of its node for the
+length of the parallel region (the previous affinity is restored after it).
+The output matrix is cut into one column stripe per node (see
+Mparallel_tiles), so the threads of a node share the columns of B and C they
+read.  Per-thread buffers (Mbuffer) are dropped when their thread moves to
+another node and are rebuilt, and therefore first touched, on the new one.
+The nodes are read from /sys/devices/system/node on Linux, restricted to the
+CPUs the process may run on; elsewhere there is a single node and no pinning.
+*/
+
+#ifndef ___MPBLAS_MNUMA_H___
+#define ___MPBLAS_MNUMA_H___
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace mpblas {
+
+inline bool &Mnuma_mode() {
+    static bool mode = []() {
+        const char *env = std::getenv("MPBLAS_NUMA");
+        return (env != nullptr) && (std::atoi(env) != 0);
+    }();
+    return mode;
+}
+
+//
+//     The CPUs of each NUMA node, nodes in increasing order; found once.
+//
+inline std::vector<std::vector<int>> const &Mnuma_nodes() {
+    static const std::vector<std::vector<int>> nodes = []() {
+        std::vector<std::vector<int>> found;
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return std::vector<std::vector<int>>(1);
+        }
+        std::vector<int> ids;
+        DIR *dir = opendir("/sys/devices/system/node");
+        if (dir != nullptr) {
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != nullptr) {
+                int id = 0;
+                char rest = 0;
+                if (std::sscanf(entry->d_name, "node%d%c", &id, &rest) == 1) {
+                    ids.push_back(id);
+                }
+            }
+            closedir(dir);
+        }
+        std::sort(ids.begin(), ids.end());
+        for (int id : ids) {
+            char path[128];
+            std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+            FILE *fp = std::fopen(path, "r");
+            if (fp == nullptr) {
+                continue;
+            }
+            //
+            //     A list of ranges such as 0-15,32-47.
+            //
+            std::vector<int> cpus;
+            int lo = 0;
+            while (std::fscanf(fp, "%d", &lo) == 1) {
+                int hi = lo;
+                int c = std::fgetc(fp);
+                if (c == '-') {
+                    if (std::fscanf(fp, "%d", &hi) != 1) {
+                        break;
+                    }
+                    c = std::fgetc(fp);
+                }
+                for (int cpu = lo; cpu <= hi; cpu++) {
+                    if ((cpu < CPU_SETSIZE) && CPU_ISSET(cpu, &allowed)) {
+                        cpus.push_back(cpu);
+                    }
+                }
+                if (c != ',') {
+                    break;
+                }
+            }
+            std::fclose(fp);
+            if (!cpus.empty()) {
+                found.push_back(cpus);
+            }
+        }
+        if (found.empty()) {
+            std::vector<int> cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            found.push_back(cpus);
+        }
+#else
+        found.resize(1);
+#endif
+        return found;
+    }();
+    return nodes;
+}
+
+//
+//     Node of the calling thread as last set by Mnuma_pin (0 before).
+//
+inline int &Mnuma_local_node() {
+    thread_local int node = 0;
+    return node;
+}
+
+//
+//     Pins the calling thread to the local-th CPU (cyclically) of the given
+//     node while it lives, and gives the thread back the CPUs it could run on
+//     before when it is destroyed, so that neither the caller's thread nor
+//     the pooled OpenMP threads stay pinned after the parallel region.
+//
+class Mnuma_pin {
+  public:
+    Mnuma_pin(int64_t const node, int64_t const local) {
+        std::vector<int> const &cpus = Mnuma_nodes()[node];
+        Mnuma_local_node() = (int)node;
+        if (cpus.empty()) {
+            return;
+        }
+#ifdef __linux__
+        const int cpu = cpus[local % (int64_t)cpus.size()];
+        CPU_ZERO(&saved);
+        if (sched_getaffinity(0, sizeof(saved), &saved) != 0) {
+            return;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        restore = (sched_setaffinity(0, sizeof(set), &set) == 0);
+#else
+        (void)local;
+#endif
+    }
+    ~Mnuma_pin() {
+#ifdef __linux__
+        if (restore) {
+            sched_setaffinity(0, sizeof(saved), &saved);
+        }
+#endif
+    }
+    Mnuma_pin(Mnuma_pin const &) = delete;
+    Mnuma_pin &operator=(Mnuma_pin const &) = delete;
+
+  private:
+#ifdef __linux__
+    cpu_set_t saved;
+#endif
+    bool restore = false;
+};
+} // namespace mpblas
+
+#endif
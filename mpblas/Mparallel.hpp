@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Helpers for the OpenMP parallel paths of the mpblas routines.
+The output matrix is cut into a tm x tn grid of tiles, one per thread, so that
+every element is computed by exactly one thread in the same order as the
+serial code; the parallel results are therefore bitwise identical.  The NUMA
+mode of Mnuma.hpp and the work-stealing scheduler of Mscheduler.hpp only
+change which thread gets which tile.
+*/
+
+#ifndef ___MPBLAS_MPARALLEL_H___
+#define ___MPBLAS_MPARALLEL_H___
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Mnuma.hpp"
+#include "Mscheduler.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace mpblas {
+
+//
+//     Number of threads a new parallel region may use: omp_get_max_threads()
+//     (i.e. OMP_NUM_THREADS), or 1 when called from inside a parallel region.
+//
+inline int Mnum_threads() {
+#ifdef _OPENMP
+    if (omp_in_parallel()) {
+        return 1;
+    }
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+//
+//     Choose a tm x tn tile grid for an m x n matrix using at most nthreads
+//     tiles.  Tiles are at least mr x nr and as close to square as possible.
+//
+inline void Mtile_grid(int64_t const m, int64_t const n, int64_t const mr, int64_t const nr, int64_t nthreads, int64_t &tm, int64_t &tn) {
+    const int64_t mblocks = (m + mr - 1) / mr;
+    const int64_t nblocks = (n + nr - 1) / nr;
+    nthreads = std::max((int64_t)1, std::min(nthreads, mblocks * nblocks));
+    tm = 1;
+    tn = 1;
+    for (int64_t p = nthreads; p >= 1; p--) {
+        double best = 0.0;
+        for (int64_t q = 1; q <= p; q++) {
+            if (p % q != 0 || q > mblocks || p / q > nblocks) {
+                continue;
+            }
+            double mt = (double)m / (double)q;
+            double nt = (double)n / (double)(p / q);
+            double perimeter = mt + nt;
+            if (tm * tn != p || perimeter < best) {
+                best = perimeter;
+                tm = q;
+                tn = p / q;
+            }
+        }
+        if (tm * tn == p) {
+            return;
+        }
+    }
+}
+
+//
+//     First index of tile t when len is split into ntiles tiles whose
+//     boundaries are multiples of align.  Tile t spans [start(t), start(t+1)).
+//
+inline int64_t Mtile_start(int64_t const t, int64_t const ntiles, int64_t const len, int64_t const align) {
+    const int64_t blocks = (len + align - 1) / align;
+    return std::min(len, (blocks * t / ntiles) * align);
+}
+
+//
+//     Run body(i0, i1, j0, j1) on the tiles [i0, i1) x [j0, j1) of a grid on
+//     an m x n matrix aligned to mr x nr, at most nthreads threads.  With
+//     tasks_per_thread above one, the grid has that many tiles per thread and
+//     they are handed out by the work-stealing scheduler (Mscheduler.hpp),
+//     column by column, so that threads that fall behind are relieved by the
+//     others; otherwise there is one tile per thread.  In NUMA mode the
+//     threads use as few nodes as hold them, the columns are first cut into
+//     one stripe per node in use, each stripe is gridded for the threads of
+//     its node, every thread is pinned to its node for the region (see
+//     Mnuma.hpp) and steals from the threads of its own node before others.
+//     Either way each tile is one independent call of body.
+//
+template <typename BODY> void Mparallel_tiles(int64_t const m, int64_t const n, int64_t const mr, int64_t const nr, int64_t const nthreads, BODY const &body, int64_t const tasks_per_thread = 1) {
+#ifdef _OPENMP
+    if (Mnuma_mode()) {
+        const int64_t width = std::max((int64_t)1, (int64_t)Mnuma_nodes()[0].size());
+        const int64_t nodes = std::max((int64_t)1, std::min(std::min((int64_t)Mnuma_nodes().size(), (nthreads + width - 1) / width), (n + nr - 1) / nr));
+        //
+        //     Node s runs threads first[s]..first[s+1]-1: nthreads / nodes
+        //     each, one more on the first nthreads % nodes nodes.  Its
+        //     stripe of columns is as wide as its share of the threads.
+        //
+        std::vector<int64_t> first(nodes + 1, 0);
+        for (int64_t s = 0; s < nodes; s++) {
+            first[s + 1] = first[s] + nthreads / nodes + ((s < nthreads % nodes) ? 1 : 0);
+        }
+        auto stripe = [&](int64_t const s) { return Mtile_start(first[s], nthreads, n, nr); };
+        //
+        //     The stripe of node s has a grid of tasks_per_thread tiles per
+        //     thread of the node, tasks start[s]..start[s+1]-1, dealt out to
+        //     the deques of its threads; a thread steals from its own node
+        //     first.
+        //
+        const int64_t tasks = std::max((int64_t)1, tasks_per_thread);
+        std::vector<int64_t> start(nodes + 1, 0);
+        std::vector<int64_t> grid_m(nodes, 1);
+        std::vector<int64_t> grid_n(nodes, 1);
+        std::vector<Mtask_deque> deques(nthreads);
+        for (int64_t s = 0; s < nodes; s++) {
+            const int64_t count = first[s + 1] - first[s];
+            const int64_t width_s = stripe(s + 1) - stripe(s);
+            Mtile_grid(m, width_s, mr, nr, count * tasks, grid_m[s], grid_n[s]);
+            start[s + 1] = start[s] + ((width_s > 0) ? grid_m[s] * grid_n[s] : 0);
+            Mtask_deal(&deques[first[s]], count, start[s], start[s + 1]);
+        }
+#pragma omp parallel num_threads(nthreads)
+        {
+            const int64_t t = omp_get_thread_num();
+            const int64_t s = std::upper_bound(first.begin(), first.end(), t) - first.begin() - 1;
+            Mnuma_pin pin(s, t - first[s]);
+            Mtask_loop(deques.data(), nthreads, t, first[s], first[s + 1] - first[s], [&](int64_t const task) {
+                const int64_t ts = std::upper_bound(start.begin(), start.end(), task) - start.begin() - 1;
+                const int64_t tm = grid_m[ts];
+                const int64_t tn = grid_n[ts];
+                const int64_t j0s = stripe(ts);
+                const int64_t j1s = stripe(ts + 1);
+                const int64_t ti = (task - start[ts]) % tm;
+                const int64_t tj = (task - start[ts]) / tm;
+                int64_t i0 = Mtile_start(ti, tm, m, mr);
+                int64_t i1 = Mtile_start(ti + 1, tm, m, mr);
+                int64_t j0 = j0s + Mtile_start(tj, tn, j1s - j0s, nr);
+                int64_t j1 = j0s + Mtile_start(tj + 1, tn, j1s - j0s, nr);
+                if ((i1 > i0) && (j1 > j0)) {
+                    body(i0, i1, j0, j1);
+                }
+            });
+        }
+        return;
+    }
+#endif
+    int64_t tm = 1;
+    int64_t tn = 1;
+    if (tasks_per_thread > 1) {
+        Mtile_grid(m, n, mr, nr, nthreads * tasks_per_thread, tm, tn);
+        Mparallel_tasks(tm * tn, nthreads, [&](int64_t const task) {
+            const int64_t ti = task % tm;
+            const int64_t tj = task / tm;
+            int64_t i0 = Mtile_start(ti, tm, m, mr);
+            int64_t i1 = Mtile_start(ti + 1, tm, m, mr);
+            int64_t j0 = Mtile_start(tj, tn, n, nr);
+            int64_t j1 = Mtile_start(tj + 1, tn, n, nr);
+            if ((i1 > i0) && (j1 > j0)) {
+                body(i0, i1, j0, j1);
+            }
+        });
+        return;
+    }
+    Mtile_grid(m, n, mr, nr, nthreads, tm, tn);
+#pragma omp parallel for collapse(2) schedule(static) num_threads(tm * tn)
+    for (int64_t ti = 0; ti < tm; ti++) {
+        for (int64_t tj = 0; tj < tn; tj++) {
+            int64_t i0 = Mtile_start(ti, tm, m, mr);
+            int64_t i1 = Mtile_start(ti + 1, tm, m, mr);
+            int64_t j0 = Mtile_start(tj, tn, n, nr);
+            int64_t j1 = Mtile_start(tj + 1, tn, n, nr);
+            if ((i1 > i0) && (j1 > j0)) {
+                body(i0, i1, j0, j1);
+            }
+        }
+    }
+}
+} // namespace mpblas
+
+#endif
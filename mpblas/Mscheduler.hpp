@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Work-stealing scheduler for the parallel paths.
+The tasks 0..ntasks-1 are dealt out in contiguous runs, one run per thread, in
+per-thread deques.  A thread takes tasks from the front of its own deque and,
+when that is empty, steals the back half of the first nonempty deque of
+another thread.  Threads that are slowed down (values of mpf_class that cost
+more, a core shared with another process) therefore lose their remaining
+work to idle threads instead of holding up the end of the product, and
+neighbouring tasks, which share operands, mostly stay on one thread.
+A deque is a range [lo, hi) of task numbers in one 64-bit atomic, updated by
+compare-and-swap both by its owner and by thieves.  Ranges only shrink or
+move into an empty deque, so a value once left never comes back and the
+compare-and-swap cannot be fooled (no ABA).
+*/
+
+#ifndef ___MPBLAS_MSCHEDULER_H___
+#define ___MPBLAS_MSCHEDULER_H___
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace mpblas {
+
+//
+//     Tasks per thread for the tile grids of the blocked routines; zero (the
+//     default, or the value of the environment variable
+//     MPBLAS_TASKS_PER_THREAD) leaves the choice to each type.
+//
+inline int64_t &Mtasks_per_thread() {
+    static int64_t tasks = []() {
+        const char *env = std::getenv("MPBLAS_TASKS_PER_THREAD");
+        return (env != nullptr) ? (int64_t)std::max(0, std::atoi(env)) : (int64_t)0;
+    }();
+    return tasks;
+}
+
+//
+//     One deque, on a cache line of its own.
+//
+struct alignas(64) Mtask_deque {
+    std::atomic<uint64_t> range;
+
+    static uint64_t pack(uint64_t const lo, uint64_t const hi) { return lo | (hi << 32); }
+    static uint64_t lo(uint64_t const r) { return r & 0xffffffffu; }
+    static uint64_t hi(uint64_t const r) { return r >> 32; }
+
+    //
+    //     Owner: take the first task.
+    //
+    bool pop(int64_t &task) {
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (lo(r) < hi(r)) {
+            if (range.compare_exchange_weak(r, pack(lo(r) + 1, hi(r)), std::memory_order_acq_rel)) {
+                task = (int64_t)lo(r);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //
+    //     Thief: take the back half (rounded up) as [first, last).
+    //
+    bool steal(int64_t &first, int64_t &last) {
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (lo(r) < hi(r)) {
+            const uint64_t mid = hi(r) - (hi(r) - lo(r) + 1) / 2;
+            if (range.compare_exchange_weak(r, pack(lo(r), mid), std::memory_order_acq_rel)) {
+                first = (int64_t)mid;
+                last = (int64_t)hi(r);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+//
+//     Deal the tasks first..last-1 out to the deques deques[0..count-1] in
+//     contiguous runs.
+//
+inline void Mtask_deal(Mtask_deque *deques, int64_t const count, int64_t const first, int64_t const last) {
+    const int64_t ntasks = last - first;
+    for (int64_t t = 0; t < count; t++) {
+        deques[t].range.store(Mtask_deque::pack(first + ntasks * t / count, first + ntasks * (t + 1) / count), std::memory_order_relaxed);
+    }
+}
+
+//
+//     The loop of thread self over the deques deques[0..nthreads-1]: run the
+//     tasks of its own deque, then steal, until every deque is empty.  The
+//     thread belongs to the group of deques [g0, g0 + group) and steals from
+//     the others in its group before it steals from outside it.
+//
+template <typename BODY> void Mtask_loop(Mtask_deque *deques, int64_t const nthreads, int64_t const self, int64_t const g0, int64_t const group, BODY const &body) {
+    Mtask_deque &own = deques[self];
+    int64_t task = 0;
+    for (;;) {
+        while (own.pop(task)) {
+            body(task);
+        }
+        int64_t first = 0;
+        int64_t last = 0;
+        bool stolen = false;
+        for (int64_t v = 1; (v < nthreads) && !stolen; v++) {
+            const int64_t victim = (v < group) ? g0 + (self - g0 + v) % group : (g0 + v) % nthreads;
+            stolen = deques[victim].steal(first, last);
+        }
+        if (!stolen) {
+            break;
+        }
+        own.range.store(Mtask_deque::pack(first + 1, last), std::memory_order_release);
+        body(first);
+    }
+}
+
+//
+//     Run body(task) for task = 0..ntasks-1 on at most nthreads OpenMP
+//     threads.  Every task runs exactly once; which thread runs it is not
+//     fixed, so body must not depend on the thread.
+//
+template <typename BODY> void Mparallel_tasks(int64_t const ntasks, int64_t nthreads, BODY const &body) {
+    nthreads = std::max((int64_t)1, std::min(nthreads, ntasks));
+#ifdef _OPENMP
+    if (nthreads > 1) {
+        std::vector<Mtask_deque> deques(nthreads);
+        Mtask_deal(deques.data(), nthreads, 0, ntasks);
+#pragma omp parallel num_threads(nthreads)
+        {
+            //
+            //     If the region has fewer threads than asked for, the deques
+            //     without an owner are emptied by stealing.
+            //
+            Mtask_loop(deques.data(), nthreads, (int64_t)omp_get_thread_num(), 0, nthreads, body);
+        }
+        return;
+    }
+#endif
+    for (int64_t task = 0; task < ntasks; task++) {
+        body(task);
+    }
+}
+} // namespace mpblas
+
+#endif
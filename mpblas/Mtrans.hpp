@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Compile-time operation flags for the typed entry points of Rgemm, Cgemm and
+Rgemv, e.g.
+    mpblas::Rgemm<mpblas::Mtrans::N, mpblas::Mtrans::T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+The transpose modes are template parameters, and so, inside, are the
+classes of alpha and beta (Mscalar), so that each combination is a loop nest
+of its own without tests on the flags or the scalars.  The routines taking
+'N'/'T'/'C' characters parse them once with Mtrans_parse and call these.
+*/
+
+#ifndef ___MPBLAS_MTRANS_H___
+#define ___MPBLAS_MTRANS_H___
+
+namespace mpblas {
+
+//
+//     op(X) = X, X**T or X**H.  For real types C is the same as T.
+//
+enum class Mtrans { N, T, C };
+
+//
+//     Class of a scalar factor: zero, one, or any other value.
+//
+enum class Mscalar { zero, one, general };
+
+//
+//     The class of x, for choices made at run time.
+//
+template <typename T> Mscalar Mscalar_of(T const &x) {
+    const T zero = 0.0;
+    const T one = 1.0;
+    if (x == zero) {
+        return Mscalar::zero;
+    }
+    return (x == one) ? Mscalar::one : Mscalar::general;
+}
+
+//
+//     The mode given by the first character of trans, in either case;
+//     false if it is none of N, T and C.
+//
+inline bool Mtrans_parse(const char *trans, Mtrans &mode) {
+    switch (*trans) {
+    case 'N':
+    case 'n':
+        mode = Mtrans::N;
+        return true;
+    case 'T':
+    case 't':
+        mode = Mtrans::T;
+        return true;
+    case 'C':
+    case 'c':
+        mode = Mtrans::C;
+        return true;
+    default:
+        return false;
+    }
+}
+} // namespace mpblas
+
+#endif
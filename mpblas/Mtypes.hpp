@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Element types whose support is in headers of their own.
+The specializations for the libqd types (dd_real, qd_real) are in qd.hpp and
+those for mpf_class in gmp.hpp.  Each includes the library's header itself, so
+the order of the includes does not matter; mpblas.hpp includes them when the
+library's header was included before it.
+Without them, a libqd or GMP type would silently get the generic loops, and a
+program whose translation units differ in this would have two definitions of
+the same template (Rgemm_kernel<dd_real>, say).  The primary templates that
+are specialized there therefore assert Mtype_ready<REAL>, which fails for such
+a type until its header has been included.
+*/
+
+#ifndef ___MPBLAS_MTYPES_H___
+#define ___MPBLAS_MTYPES_H___
+
+#include <concepts>
+
+namespace mpblas {
+
+//
+//     Set to true by qd.hpp and gmp.hpp for the types they support.
+//
+template <typename REAL> struct Mtype_support {
+    static constexpr bool included = false;
+};
+
+//
+//     A libqd type (an array x of doubles) or mpf_class (get_mpf_t()).
+//
+template <typename REAL>
+concept Mtype_external = requires(REAL const &x) { x.get_mpf_t(); } || requires(REAL const &x) {
+    { x.x[0] } -> std::same_as<double const &>;
+};
+
+template <typename REAL> constexpr bool Mtype_ready = !Mtype_external<REAL> || Mtype_support<REAL>::included;
+} // namespace mpblas
+
+#endif
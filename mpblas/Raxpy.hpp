@@ -26,6 +26,8 @@
  *
  */
 
+#include "Raxpy_simd.hpp"
+
 namespace mpblas {
 template <typename REAL> void Raxpy(int64_t const n, REAL const &da, REAL *dx, int64_t const incx, REAL *dy, int64_t const incy) {
     if (n <= 0) {
@@ -34,33 +36,15 @@ template <typename REAL> void Raxpy(int64_t const n, REAL const &da, REAL *dx, i
     if (da == 0.0) {
         return;
     }
-    int64_t m = 0;
     int64_t i = 0;
-    int64_t mp1 = 0;
     int64_t ix = 0;
     int64_t iy = 0;
     if (incx == 1 && incy == 1) {
         //
-        //        code for both increments equal to 1
-        //
-        //        clean-up loop
+        //        code for both increments equal to 1: vectorized and
+        //        threaded in Raxpy_unit (Raxpy_simd.hpp)
         //
-        m = n % 4;
-        if (m != 0) {
-            for (i = 1; i <= m; i = i + 1) {
-                dy[i - 1] += da * dx[i - 1];
-            }
-        }
-        if (n < 4) {
-            return;
-        }
-        mp1 = m + 1;
-        for (i = mp1; i <= n; i = i + 4) {
-            dy[i - 1] += da * dx[i - 1];
-            dy[(i + 1) - 1] += da * dx[(i + 1) - 1];
-            dy[(i + 2) - 1] += da * dx[(i + 2) - 1];
-            dy[(i + 3) - 1] += da * dx[(i + 3) - 1];
-        }
+        Raxpy_unit(n, da, (REAL const *)dx, dy);
     } else {
         //
         //        code for unequal increments or equal increments
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Raxpy for unit increments: y := y + a*x on chunks of the vectors, one chunk
+per OpenMP thread once n is worth it, each chunk updated by Raxpy_kernel.
+The kernel is the unrolled loop of the reference Raxpy, except for
+  float, double  SSE2, AVX2+FMA or AVX-512F loops (as chosen for Rgemm); the
+                 last two round a*x + y once
+  _Float16       eight elements at a time through F16C, in float
+  dd_real        the hi and lo limbs of eight (AVX-512F) or four (AVX2) x(i)
+                 and y(i) separated in registers by unpack instructions, and
+                 the multiply-add of the blocked Rgemm kernels
+                 (Rgemm_qd_lanes.hpp) run on them
+The instruction set is chosen once at run time.  The float, double and
+_Float16 loops write y with non-temporal stores when y is larger than the
+last-level cache, as it would only evict x and y themselves from there; dd_real
+does enough arithmetic per element that it is not limited by memory.  Every
+element is computed the same way wherever it lies, so the result does not
+depend on the number of threads.
+*/
+
+#ifndef ___MPBLAS_RAXPY_SIMD_H___
+#define ___MPBLAS_RAXPY_SIMD_H___
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include "Mparallel.hpp"
+#include "Mtypes.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     Each OpenMP thread is given at least work_per_thread elements; the
+//     chunks are multiples of align elements, a cache line.
+//
+template <typename REAL> struct Raxpy_blocking {
+    static constexpr int64_t work_per_thread = (sizeof(REAL) <= 8) ? 65536 : 4096;
+    static constexpr int64_t align = std::max((int64_t)1, (int64_t)(64 / sizeof(REAL)));
+};
+
+//
+//     y(0:n-1) := y(0:n-1) + a*x(0:n-1); stream asks for non-temporal stores
+//     where the kernel has them.  Specialized below.
+//
+template <typename REAL> struct Raxpy_kernel {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static void run(int64_t const n, REAL const &da, REAL const *dx, REAL *dy, bool const) {
+        int64_t m = n % 4;
+        int64_t i = 0;
+        for (i = 0; i < m; i++) {
+            dy[i] += da * dx[i];
+        }
+        for (i = m; i < n; i += 4) {
+            dy[i] += da * dx[i];
+            dy[i + 1] += da * dx[i + 1];
+            dy[i + 2] += da * dx[i + 2];
+            dy[i + 3] += da * dx[i + 3];
+        }
+    }
+};
+
+#if defined(__x86_64__) && defined(__GNUC__)
+//
+//     Number of elements before the first one of y that is aligned to bytes
+//     (n if there is none).
+//
+template <typename T> int64_t Raxpy_peel(int64_t const n, T const *y, int64_t const bytes) {
+    const uintptr_t p = (uintptr_t)y;
+    if (p % sizeof(T) != 0) {
+        return n;
+    }
+    return std::min(n, (int64_t)(((bytes - p % bytes) % bytes) / sizeof(T)));
+}
+
+template <typename T> void Raxpy_sse2(int64_t const n, T const a, T const *x, T *y, bool const stream) {
+    typedef Rgemm_sse2<T> S;
+    constexpr int64_t L = S::L;
+    const int64_t peel = stream ? Raxpy_peel(n, y, L * sizeof(T)) : 0;
+    int64_t i = 0;
+    for (; i < peel; i++) {
+        y[i] += a * x[i];
+    }
+    typename S::V va = S::broadcast(&a);
+    if (stream) {
+        for (; i + 4 * L <= n; i += 4 * L) {
+            for (int64_t v = 0; v < 4; v++) {
+                S::stream(&y[i + v * L], S::fma(va, S::load(&x[i + v * L]), S::load(&y[i + v * L])));
+            }
+        }
+        _mm_sfence();
+    }
+    for (; i + 4 * L <= n; i += 4 * L) {
+        for (int64_t v = 0; v < 4; v++) {
+            S::store(&y[i + v * L], S::fma(va, S::load(&x[i + v * L]), S::load(&y[i + v * L])));
+        }
+    }
+    for (; i < n; i++) {
+        y[i] += a * x[i];
+    }
+}
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+template <typename T> void Raxpy_avx2(int64_t const n, T const a, T const *x, T *y, bool const stream) {
+    typedef Rgemm_avx2<T> S;
+    constexpr int64_t L = S::L;
+    const int64_t peel = stream ? Raxpy_peel(n, y, L * sizeof(T)) : 0;
+    int64_t i = 0;
+    for (; i < peel; i++) {
+        y[i] = std::fma(a, x[i], y[i]);
+    }
+    typename S::V va = S::broadcast(&a);
+    if (stream) {
+        for (; i + 4 * L <= n; i += 4 * L) {
+            for (int64_t v = 0; v < 4; v++) {
+                S::stream(&y[i + v * L], S::fma(va, S::load(&x[i + v * L]), S::load(&y[i + v * L])));
+            }
+        }
+        _mm_sfence();
+    }
+    for (; i + 4 * L <= n; i += 4 * L) {
+        for (int64_t v = 0; v < 4; v++) {
+            S::store(&y[i + v * L], S::fma(va, S::load(&x[i + v * L]), S::load(&y[i + v * L])));
+        }
+    }
+    for (; i < n; i++) {
+        y[i] = std::fma(a, x[i], y[i]);
+    }
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+template <typename T> void Raxpy_avx512(int64_t const n, T const a, T const *x, T *y, bool const stream) {
+    typedef Rgemm_avx512<T> S;
+    constexpr int64_t L = S::L;
+    const int64_t peel = stream ? Raxpy_peel(n, y, L * sizeof(T)) : 0;
+    int64_t i = 0;
+    for (; i < peel; i++) {
+        y[i] = std::fma(a, x[i], y[i]);
+    }
+    typename S::V va = S::broadcast(&a);
+    if (stream) {
+        for (; i + 4 * L <= n; i += 4 * L) {
+            for (int64_t v = 0; v < 4; v++) {
+                S::stream(&y[i + v * L], S::fma(va, S::load(&x[i + v * L]), S::load(&y[i + v * L])));
+            }
+        }
+        _mm_sfence();
+    }
+    for (; i + 4 * L <= n; i += 4 * L) {
+        for (int64_t v = 0; v < 4; v++) {
+            S::store(&y[i + v * L], S::fma(va, S::load(&x[i + v * L]), S::load(&y[i + v * L])));
+        }
+    }
+    for (; i < n; i++) {
+        y[i] = std::fma(a, x[i], y[i]);
+    }
+}
+#pragma GCC pop_options
+
+//
+//     The loop of the widest instruction set the CPU supports; found once per
+//     type.
+//
+template <typename T> struct Raxpy_simd {
+    typedef void (*loop_t)(int64_t const n, T const a, T const *x, T *y, bool const stream);
+    static loop_t select() {
+        static const loop_t loop = []() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return &Raxpy_avx512<T>;
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return &Raxpy_avx2<T>;
+            }
+            return &Raxpy_sse2<T>;
+        }();
+        return loop;
+    }
+    static void run(int64_t const n, T const &da, T const *dx, T *dy, bool const stream) { select()(n, da, dx, dy, stream); }
+};
+
+template <> struct Raxpy_kernel<double> : Raxpy_simd<double> {};
+template <> struct Raxpy_kernel<float> : Raxpy_simd<float> {};
+
+#ifdef __FLT16_MANT_DIG__
+//
+//     _Float16: a*x(i) is exact in float and a*x(i) + y(i) is rounded once to
+//     float and then to _Float16.
+//
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c")
+inline void Raxpy_f16c(int64_t const n, _Float16 const a, _Float16 const *x, _Float16 *y, bool const stream) {
+    const int64_t peel = stream ? Raxpy_peel(n, y, 16) : 0;
+    const float af = (float)a;
+    int64_t i = 0;
+    for (; i < peel; i++) {
+        y[i] = (_Float16)std::fma(af, (float)x[i], (float)y[i]);
+    }
+    const __m256 va = _mm256_set1_ps(af);
+    for (; i + 8 <= n; i += 8) {
+        __m256 xv = _mm256_cvtph_ps(_mm_loadu_si128((__m128i const *)&x[i]));
+        __m256 yv = _mm256_cvtph_ps(_mm_loadu_si128((__m128i const *)&y[i]));
+        __m128i r = _mm256_cvtps_ph(_mm256_fmadd_ps(va, xv, yv), _MM_FROUND_TO_NEAREST_INT);
+        if (stream) {
+            _mm_stream_si128((__m128i *)&y[i], r);
+        } else {
+            _mm_storeu_si128((__m128i *)&y[i], r);
+        }
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+    for (; i < n; i++) {
+        y[i] = (_Float16)std::fma(af, (float)x[i], (float)y[i]);
+    }
+}
+#pragma GCC pop_options
+
+template <> struct Raxpy_kernel<_Float16> {
+    static void run(int64_t const n, _Float16 const &da, _Float16 const *dx, _Float16 *dy, bool const stream) {
+        static const bool f16c = []() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+        }();
+        if (f16c) {
+            Raxpy_f16c(n, da, dx, dy, stream);
+        } else {
+            for (int64_t i = 0; i < n; i++) {
+                dy[i] += da * dx[i];
+            }
+        }
+    }
+};
+#endif
+#endif
+
+//
+//     dd_real (selected in qd.hpp): two vectors of x (or y) hold the limbs of
+//     L elements as hi, lo, hi, lo, ...; unpacklo/unpackhi of the pair give
+//     the hi and the lo limbs of the same L elements (in the same permuted
+//     order), and unpacklo/unpackhi of hi and lo put them back.
+//
+template <typename REAL> void Raxpy_dd_scalar(int64_t const n, REAL const &a, REAL const *x, REAL *y) {
+    for (int64_t i = 0; i < n; i++) {
+        Rgemm_qd_scalar::dd_madd(a.x[0], a.x[1], x[i].x[0], x[i].x[1], y[i].x[0], y[i].x[1]);
+    }
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+template <typename REAL> void Raxpy_dd_avx2(int64_t const n, REAL const &a, REAL const *x, REAL *y) {
+    using namespace Rgemm_qd_avx2;
+    const V a0 = vbroadcast(&a.x[0]);
+    const V a1 = vbroadcast(&a.x[1]);
+    int64_t i = 0;
+    for (; i + L <= n; i += L) {
+        double const *xp = &x[i].x[0];
+        double *yp = &y[i].x[0];
+        V x01 = vload(xp);
+        V x23 = vload(xp + L);
+        V y01 = vload(yp);
+        V y23 = vload(yp + L);
+        V b0 = _mm256_unpacklo_pd(x01, x23);
+        V b1 = _mm256_unpackhi_pd(x01, x23);
+        V c0 = _mm256_unpacklo_pd(y01, y23);
+        V c1 = _mm256_unpackhi_pd(y01, y23);
+        dd_madd(a0, a1, b0, b1, c0, c1);
+        vstore(yp, _mm256_unpacklo_pd(c0, c1));
+        vstore(yp + L, _mm256_unpackhi_pd(c0, c1));
+    }
+    Raxpy_dd_scalar(n - i, a, &x[i], &y[i]);
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+template <typename REAL> void Raxpy_dd_avx512(int64_t const n, REAL const &a, REAL const *x, REAL *y) {
+    using namespace Rgemm_qd_avx512;
+    const V a0 = vbroadcast(&a.x[0]);
+    const V a1 = vbroadcast(&a.x[1]);
+    int64_t i = 0;
+    for (; i + L <= n; i += L) {
+        double const *xp = &x[i].x[0];
+        double *yp = &y[i].x[0];
+        V x01 = vload(xp);
+        V x23 = vload(xp + L);
+        V y01 = vload(yp);
+        V y23 = vload(yp + L);
+        V b0 = _mm512_unpacklo_pd(x01, x23);
+        V b1 = _mm512_unpackhi_pd(x01, x23);
+        V c0 = _mm512_unpacklo_pd(y01, y23);
+        V c1 = _mm512_unpackhi_pd(y01, y23);
+        dd_madd(a0, a1, b0, b1, c0, c1);
+        vstore(yp, _mm512_unpacklo_pd(c0, c1));
+        vstore(yp + L, _mm512_unpackhi_pd(c0, c1));
+    }
+    Raxpy_dd_scalar(n - i, a, &x[i], &y[i]);
+}
+#pragma GCC pop_options
+#endif
+
+template <typename REAL> struct Raxpy_kernel_dd {
+    typedef void (*loop_t)(int64_t const n, REAL const &a, REAL const *x, REAL *y);
+    static void run(int64_t const n, REAL const &da, REAL const *dx, REAL *dy, bool const) {
+        static const loop_t loop = []() {
+#if defined(__x86_64__) && defined(__GNUC__)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return &Raxpy_dd_avx512<REAL>;
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return &Raxpy_dd_avx2<REAL>;
+            }
+#endif
+            return &Raxpy_dd_scalar<REAL>;
+        }();
+        loop(n, da, dx, dy);
+    }
+};
+
+//
+//     Size of the last-level cache in bytes, 32 MiB if the system does not
+//     tell.
+//
+inline int64_t Raxpy_llc_bytes() {
+    static const int64_t bytes = []() {
+        long size = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (size <= 0) {
+            size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+        return (size > 0) ? (int64_t)size : (int64_t)32 * 1024 * 1024;
+    }();
+    return bytes;
+}
+
+//
+//     dy := dy + da*dx for unit increments, n > 0.
+//
+template <typename REAL> void Raxpy_unit(int64_t const n, REAL const &da, REAL const *dx, REAL *dy) {
+    const bool stream = (n * (int64_t)sizeof(REAL) > Raxpy_llc_bytes());
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), n / Raxpy_blocking<REAL>::work_per_thread);
+    if (nthreads <= 1) {
+        Raxpy_kernel<REAL>::run(n, da, dx, dy, stream);
+        return;
+    }
+    Mparallel_tiles(n, 1, Raxpy_blocking<REAL>::align, 1, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const, int64_t const) { Raxpy_kernel<REAL>::run(i1 - i0, da, &dx[i0], &dy[i0], stream); }, Rgemm_tasks_per_thread<REAL>());
+}
+} // namespace mpblas
+
+#endif
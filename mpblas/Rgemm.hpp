@@ -26,37 +26,141 @@
  *
  */
 
+#ifndef ___MPBLAS_RGEMM_H___
+#define ___MPBLAS_RGEMM_H___
+
+#include <type_traits>
 #include "Mlsame.hpp"
 #include "Mxerbla.hpp"
+#include "Mtrans.hpp"
+#include "Mgemm_algo.hpp"
+#include "Rgemm_blocked.hpp"
+#include "Rgemm_ozaki.hpp"
+#include "Rgemm_strassen.hpp"
+#include "Rgemm_recursive.hpp"
+#include "Rgemm_ksplit.hpp"
+#include "Rgemm_mixed.hpp"
 
 namespace mpblas {
-template <typename REAL> void Rgemm(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
-    //
-    //     Test the input parameters.
-    //
-    bool nota = Mlsame(transa, "N");
-    bool notb = Mlsame(transb, "N");
-    int64_t nrowa = 0;
-    if (nota) {
-        nrowa = m;
+
+//
+//     The reference loops of Rgemm for one combination of op(A) = TA,
+//     op(B) = TB, alpha of class ALPHA (one or general) and beta of class
+//     BETA.  The results are those of the loops with the tests taken at run
+//     time.
+//
+template <Mtrans TA, Mtrans TB, Mscalar ALPHA, Mscalar BETA, typename REAL> void Rgemm_loops(int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL const *a, int64_t const lda, REAL const *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    int64_t i = 0;
+    int64_t j = 0;
+    int64_t l = 0;
+    REAL temp = 0.0;
+    if constexpr (TA == Mtrans::N) {
+        //
+        //        Form  C := alpha*A*op(B) + beta*C, one column at a time.
+        //
+        for (j = 0; j < n; j++) {
+            REAL *cj = &c[j * ldc];
+            if constexpr (BETA == Mscalar::zero) {
+                for (i = 0; i < m; i++) {
+                    cj[i] = zero;
+                }
+            } else if constexpr (BETA == Mscalar::general) {
+                for (i = 0; i < m; i++) {
+                    cj[i] = beta * cj[i];
+                }
+            }
+            for (l = 0; l < k; l++) {
+                REAL const &blj = (TB == Mtrans::N) ? b[l + j * ldb] : b[j + l * ldb];
+                if constexpr (ALPHA == Mscalar::one) {
+                    temp = blj;
+                } else {
+                    temp = alpha * blj;
+                }
+                REAL const *al = &a[l * lda];
+                for (i = 0; i < m; i++) {
+                    cj[i] += temp * al[i];
+                }
+            }
+        }
     } else {
-        nrowa = k;
+        //
+        //        Form  C := alpha*A**T*op(B) + beta*C, one dot product per
+        //        element.
+        //
+        for (j = 0; j < n; j++) {
+            for (i = 0; i < m; i++) {
+                REAL const *ai = &a[i * lda];
+                temp = zero;
+                if constexpr (TB == Mtrans::N) {
+                    REAL const *bj = &b[j * ldb];
+                    for (l = 0; l < k; l++) {
+                        temp += ai[l] * bj[l];
+                    }
+                } else {
+                    for (l = 0; l < k; l++) {
+                        temp += ai[l] * b[j + l * ldb];
+                    }
+                }
+                REAL &cij = c[i + j * ldc];
+                if constexpr (ALPHA == Mscalar::one && BETA == Mscalar::zero) {
+                    cij = temp;
+                } else if constexpr (ALPHA == Mscalar::one && BETA == Mscalar::one) {
+                    cij = temp + cij;
+                } else if constexpr (ALPHA == Mscalar::one) {
+                    cij = temp + beta * cij;
+                } else if constexpr (BETA == Mscalar::zero) {
+                    cij = alpha * temp;
+                } else if constexpr (BETA == Mscalar::one) {
+                    cij = alpha * temp + cij;
+                } else {
+                    cij = alpha * temp + beta * cij;
+                }
+            }
+        }
     }
-    int64_t nrowb = 0;
-    if (notb) {
-        nrowb = k;
+}
+
+//
+//     Rgemm_loops for the classes of alpha (nonzero) and beta.
+//
+template <Mtrans TA, Mtrans TB, typename REAL> void Rgemm_reference(int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL const *a, int64_t const lda, REAL const *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    if (alpha == one) {
+        if (beta == zero) {
+            Rgemm_loops<TA, TB, Mscalar::one, Mscalar::zero>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else if (beta == one) {
+            Rgemm_loops<TA, TB, Mscalar::one, Mscalar::one>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else {
+            Rgemm_loops<TA, TB, Mscalar::one, Mscalar::general>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
     } else {
-        nrowb = n;
+        if (beta == zero) {
+            Rgemm_loops<TA, TB, Mscalar::general, Mscalar::zero>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else if (beta == one) {
+            Rgemm_loops<TA, TB, Mscalar::general, Mscalar::one>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else {
+            Rgemm_loops<TA, TB, Mscalar::general, Mscalar::general>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
     }
+}
+
+//
+//     Rgemm with the transpose modes as template parameters:
+//       Rgemm<Mtrans::N, Mtrans::T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc)
+//     The other arguments and the error codes are those of Rgemm below.
+//
+template <Mtrans TA, Mtrans TB, typename REAL> void Rgemm(int64_t const m, int64_t const n, int64_t const k, std::type_identity_t<REAL> const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, std::type_identity_t<REAL> const &beta, REAL *c, int64_t const ldc, Mgemm_algo const algo = Mgemm_algo::automatic) {
+    constexpr bool nota = (TA == Mtrans::N);
+    constexpr bool notb = (TB == Mtrans::N);
+    const int64_t nrowa = nota ? m : k;
+    const int64_t nrowb = notb ? k : n;
     //
     //     Test the input parameters.
     //
     int64_t info = 0;
-    if ((!nota) && (!Mlsame(transa, "C")) && (!Mlsame(transa, "T"))) {
-        info = 1;
-    } else if ((!notb) && (!Mlsame(transb, "C")) && (!Mlsame(transb, "T"))) {
-        info = 2;
-    } else if (m < 0) {
+    if (m < 0) {
         info = 3;
     } else if (n < 0) {
         info = 4;
@@ -84,108 +188,83 @@ template <typename REAL> void Rgemm(const char *transa, const char *transb, int6
     //
     //     And if  alpha.eq.zero.
     //
-    int64_t j = 0;
-    int64_t i = 0;
     if (alpha == zero) {
-        if (beta == zero) {
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    c[(i - 1) + (j - 1) * ldc] = zero;
-                }
-            }
-        } else {
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                }
-            }
+        Rgemm_scale(m, n, beta, zero, one, c, ldc);
+        return;
+    }
+    //
+    //     Ozaki scheme, on request only.
+    //
+    if constexpr (Rgemm_ozaki_traits<REAL>::enabled) {
+        if (algo == Mgemm_algo::ozaki) {
+            Rgemm_ozaki(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+            return;
         }
+    }
+    //
+    //     Cache-oblivious recursion, on request only.
+    //
+    if ((algo == Mgemm_algo::recursive) || (algo == Mgemm_algo::morton)) {
+        Rgemm_recursive(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo == Mgemm_algo::morton);
+        return;
+    }
+    //
+    //     k split across threads when C is too small to keep them busy, or on
+    //     request.
+    //
+    if ((algo == Mgemm_algo::ksplit) || ((algo == Mgemm_algo::automatic) && Rgemm_use_ksplit<REAL>(m, n, k))) {
+        Rgemm_ksplit(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    //
+    //     Strassen-Winograd for large products of expensive types, or on
+    //     request.
+    //
+    if ((algo == Mgemm_algo::strassen) || ((algo == Mgemm_algo::automatic) && Rgemm_use_strassen<REAL>(m, n, k))) {
+        Rgemm_strassen(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    //
+    //     Use the packed, cache-blocked engine unless the problem is tiny.
+    //
+    if (Rgemm_use_blocked<REAL>(m, n, k)) {
+        Rgemm_blocked(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
         return;
     }
     //
     //     Start the operations.
     //
-    int64_t l = 0;
-    REAL temp = 0.0;
-    if (notb) {
-        if (nota) {
-            //
-            //           Form  C := alpha*A*B + beta*C.
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                if (beta == zero) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = zero;
-                    }
-                } else if (beta != one) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-                for (l = 1; l <= k; l = l + 1) {
-                    temp = alpha * b[(l - 1) + (j - 1) * ldb];
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] += temp * a[(i - 1) + (l - 1) * lda];
-                    }
-                }
-            }
+    Rgemm_reference<nota ? Mtrans::N : Mtrans::T, notb ? Mtrans::N : Mtrans::T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+template <typename REAL> void Rgemm(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc, Mgemm_algo const algo = Mgemm_algo::automatic) {
+    //
+    //     Test the input parameters.
+    //
+    Mtrans ta = Mtrans::N;
+    Mtrans tb = Mtrans::N;
+    if (!Mtrans_parse(transa, ta)) {
+        Mxerbla("Rgemm ", 1);
+        return;
+    }
+    if (!Mtrans_parse(transb, tb)) {
+        Mxerbla("Rgemm ", 2);
+        return;
+    }
+    //
+    //     The rest is done by the typed Rgemm; for real matrices C is T.
+    //
+    if (ta == Mtrans::N) {
+        if (tb == Mtrans::N) {
+            Rgemm<Mtrans::N, Mtrans::N>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
         } else {
-            //
-            //           Form  C := alpha*A**T*B + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += a[(l - 1) + (i - 1) * lda] * b[(l - 1) + (j - 1) * ldb];
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
+            Rgemm<Mtrans::N, Mtrans::T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
         }
     } else {
-        if (nota) {
-            //
-            //           Form  C := alpha*A*B**T + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                if (beta == zero) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = zero;
-                    }
-                } else if (beta != one) {
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] = beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-                for (l = 1; l <= k; l = l + 1) {
-                    temp = alpha * b[(j - 1) + (l - 1) * ldb];
-                    for (i = 1; i <= m; i = i + 1) {
-                        c[(i - 1) + (j - 1) * ldc] += temp * a[(i - 1) + (l - 1) * lda];
-                    }
-                }
-            }
+        if (tb == Mtrans::N) {
+            Rgemm<Mtrans::T, Mtrans::N>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
         } else {
-            //
-            //           Form  C := alpha*A**T*B**T + beta*C
-            //
-            for (j = 1; j <= n; j = j + 1) {
-                for (i = 1; i <= m; i = i + 1) {
-                    temp = zero;
-                    for (l = 1; l <= k; l = l + 1) {
-                        temp += a[(l - 1) + (i - 1) * lda] * b[(j - 1) + (l - 1) * ldb];
-                    }
-                    if (beta == zero) {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp;
-                    } else {
-                        c[(i - 1) + (j - 1) * ldc] = alpha * temp + beta * c[(i - 1) + (j - 1) * ldc];
-                    }
-                }
-            }
+            Rgemm<Mtrans::T, Mtrans::T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, algo);
         }
     }
     //
@@ -193,3 +272,5 @@ template <typename REAL> void Rgemm(const char *transa, const char *transb, int6
     //
 }
 } // namespace mpblas
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Batched Rgemm: C_p := alpha*op(A_p)*op(B_p) + beta*C_p for p = 0..batch_count-1,
+all products of the same shape.
+  Rgemm_batched          A_p = a[p], B_p = b[p], C_p = c[p]
+  Rgemm_strided_batched  A_p = a + p*stridea, B_p = b + p*strideb, C_p = c + p*stridec
+The arguments are checked and the products distributed by Mbatched.hpp: one
+product per OpenMP thread on the blocked engine with that thread's packing
+buffers when there are at least as many products as threads, one product
+after another with all threads otherwise.  Either way every product is
+bitwise identical to the corresponding blocked Rgemm.
+*/
+
+#ifndef ___MPBLAS_RGEMM_BATCHED_H___
+#define ___MPBLAS_RGEMM_BATCHED_H___
+
+#include "Mxerbla.hpp"
+#include "Mbatched.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     The products of a validated batch; operands(p, a, b, c) sets the
+//     matrices of product p.
+//
+template <typename REAL, typename OPERANDS> void Rgemm_batch(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, int64_t const lda, int64_t const ldb, REAL const &beta, int64_t const ldc, int64_t const batch_count, OPERANDS const &operands) {
+    bool nota = Mlsame(transa, "N");
+    bool notb = Mlsame(transb, "N");
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    Mbatch(m, n, k, alpha, beta, zero, one, ldc, batch_count, operands, [&](bool const threaded, REAL *a, REAL *b, REAL *c) {
+        if (threaded) {
+            Rgemm_blocked(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        } else {
+            Rgemm_update(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, zero, one, c, ldc);
+        }
+    });
+}
+
+template <typename REAL> void Rgemm_batched(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL **a, int64_t const lda, REAL **b, int64_t const ldb, REAL const &beta, REAL **c, int64_t const ldc, int64_t const batch_count) {
+    int64_t info = Mbatched_info(transa, transb, m, n, k, lda, ldb, ldc, batch_count, false, 0, 0, 0);
+    if (info != 0) {
+        Mxerbla("Rgemm_batched ", info);
+        return;
+    }
+    Rgemm_batch(transa, transb, m, n, k, alpha, lda, ldb, beta, ldc, batch_count, [&](int64_t const p, REAL *&ap, REAL *&bp, REAL *&cp) {
+        ap = a[p];
+        bp = b[p];
+        cp = c[p];
+    });
+}
+
+//
+//     stridea and strideb may be zero to use one A or B for the whole batch;
+//     the C_p must not overlap: stridec >= ldc*(n-1) + m.
+//
+template <typename REAL> void Rgemm_strided_batched(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, int64_t const stridea, REAL *b, int64_t const ldb, int64_t const strideb, REAL const &beta, REAL *c, int64_t const ldc, int64_t const stridec, int64_t const batch_count) {
+    int64_t info = Mbatched_info(transa, transb, m, n, k, lda, ldb, ldc, batch_count, true, stridea, strideb, stridec);
+    if (info != 0) {
+        Mxerbla("Rgemm_strided_batched ", info);
+        return;
+    }
+    Rgemm_batch(transa, transb, m, n, k, alpha, lda, ldb, beta, ldc, batch_count, [&](int64_t const p, REAL *&ap, REAL *&bp, REAL *&cp) {
+        ap = a + p * stridea;
+        bp = b + p * strideb;
+        cp = c + p * stridec;
+    });
+}
+} // namespace mpblas
+
+#endif
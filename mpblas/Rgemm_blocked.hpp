@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Cache-blocked GEMM engine in the style of GotoBLAS.
+C is updated by MC x NC blocks; for each KC-wide slice of k, a KC x NC panel of
+op(B) and an MC x KC block of op(A) are copied into contiguous buffers (the
+"packed" panels) and an MR x NR micro-kernel sweeps over them.  Packing reads
+op(A) and op(B) through their row and column strides, so the transposed cases
+feed the micro-kernel the same unit-stride data as the "N" cases.
+beta is applied by the micro-kernel as it stores the first KC slice, so C is
+read and written once per KC slice and not read at all when beta is zero.
+*/
+
+#ifndef ___MPBLAS_RGEMM_BLOCKED_H___
+#define ___MPBLAS_RGEMM_BLOCKED_H___
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Mtrans.hpp"
+#include "Mtypes.hpp"
+#include "Rgemm_tuning.hpp"
+
+namespace mpblas {
+
+//
+//     Blocking parameters.  MR x NR is the register tile of the micro-kernel,
+//     MC x KC the packed block of A (sized for L2), KC x NC the packed panel of
+//     B (sized for L3).  The defaults are derived from the storage size of REAL.
+//     Problems with fewer than threshold multiply-adds use the reference loops,
+//     and each OpenMP thread is given at least work_per_thread of them.  The
+//     software types, whose operations cost more or less depending on the
+//     values, cut C into tasks_per_thread tiles per thread for the
+//     work-stealing scheduler (Mscheduler.hpp); the hardware types keep one.
+//
+template <typename REAL> struct Rgemm_blocking {
+    static constexpr int64_t MR = (sizeof(REAL) <= 8) ? 8 : 4;
+    static constexpr int64_t NR = 4;
+    static constexpr int64_t KC = std::min((int64_t)256, std::max((int64_t)32, (int64_t)(16384 / (NR * sizeof(REAL)))));
+    static constexpr int64_t MC = std::max(MR, (int64_t)(262144 / (KC * sizeof(REAL))) / MR * MR);
+    static constexpr int64_t NC = std::max(NR, (int64_t)(4194304 / (KC * sizeof(REAL))) / NR * NR);
+    static constexpr int64_t threshold = 32768;
+    static constexpr int64_t work_per_thread = 262144;
+    static constexpr int64_t tasks_per_thread = (sizeof(REAL) <= 8) ? 1 : 4;
+};
+
+//
+//     Tiles per thread in use: Mtasks_per_thread() if set, else the default.
+//
+template <typename REAL> int64_t Rgemm_tasks_per_thread() { return (Mtasks_per_thread() > 0) ? Mtasks_per_thread() : Rgemm_blocking<REAL>::tasks_per_thread; }
+
+//
+//     Cache blocks in use: those of the tuning file or Rgemm_tuning_override
+//     (see Rgemm_tuning.hpp), else the defaults above.  MC and NC are rounded
+//     up to multiples of the register tile.
+//
+template <typename REAL> void Rgemm_blocks(int64_t const mr, int64_t const nr, int64_t &MC, int64_t &KC, int64_t &NC) {
+    const Rgemm_tuning t = Rgemm_tuned<REAL>();
+    MC = ((t.mc > 0 ? t.mc : Rgemm_blocking<REAL>::MC) + mr - 1) / mr * mr;
+    KC = (t.kc > 0) ? t.kc : Rgemm_blocking<REAL>::KC;
+    NC = ((t.nc > 0 ? t.nc : Rgemm_blocking<REAL>::NC) + nr - 1) / nr * nr;
+}
+
+//
+//     Copy the mc x kc block of op(A) at a into ap as a sequence of MR x kc
+//     slivers, each stored column by column.  op(A)(i,l) is a[i * rsa + l * csa].
+//     The packed type may be wider than REAL; elements are converted on copy.
+//
+template <typename REAL, typename PACKED> void Rgemm_pack_a(int64_t const mc, int64_t const kc, REAL const *a, int64_t const rsa, int64_t const csa, int64_t const mr, PACKED *ap) {
+    const PACKED zero = 0.0;
+    for (int64_t ir = 0; ir < mc; ir += mr) {
+        int64_t ib = std::min(mr, mc - ir);
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t i = 0; i < ib; i++) {
+                ap[i] = a[(ir + i) * rsa + l * csa];
+            }
+            for (int64_t i = ib; i < mr; i++) {
+                ap[i] = zero;
+            }
+            ap += mr;
+        }
+    }
+}
+
+//
+//     Copy the kc x nc panel of op(B) at b into bp as a sequence of kc x NR
+//     slivers, each stored row by row.  op(B)(l,j) is b[l * rsb + j * csb].
+//
+template <typename REAL, typename PACKED> void Rgemm_pack_b(int64_t const kc, int64_t const nc, REAL const *b, int64_t const rsb, int64_t const csb, int64_t const nr, PACKED *bp) {
+    const PACKED zero = 0.0;
+    for (int64_t jr = 0; jr < nc; jr += nr) {
+        int64_t jb = std::min(nr, nc - jr);
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t j = 0; j < jb; j++) {
+                bp[j] = b[l * rsb + (jr + j) * csb];
+            }
+            for (int64_t j = jb; j < nr; j++) {
+                bp[j] = zero;
+            }
+            bp += nr;
+        }
+    }
+}
+
+//
+//     c := alpha*x + beta*c as a micro-kernel stores its tile, alpha and beta
+//     being of the classes ca and cb (Mscalar_of): c is not read when beta
+//     is zero, and factors of one are not multiplied.
+//
+template <typename REAL> void Rgemm_store(Mscalar const ca, REAL const &alpha, REAL const &x, Mscalar const cb, REAL const &beta, REAL &c) {
+    if (cb == Mscalar::zero) {
+        c = (ca == Mscalar::one) ? x : REAL(alpha * x);
+    } else if (cb == Mscalar::one) {
+        c += (ca == Mscalar::one) ? x : REAL(alpha * x);
+    } else {
+        c = ((ca == Mscalar::one) ? x : REAL(alpha * x)) + beta * c;
+    }
+}
+
+//
+//     Micro-kernel: C(0:mr-1, 0:nr-1) := alpha * Ap * Bp + beta * C, where Ap
+//     is a packed MR x kc sliver of op(A) and Bp a packed kc x NR sliver of
+//     op(B).  C is not read when beta is zero.  mr and nr are at most MR and
+//     NR; the packed slivers are zero padded.
+//     Specialize this for types with a faster kernel; a specialization may
+//     pack into another element type (packed_t) with its own pack_a/pack_b,
+//     using packed_size of them per element of REAL.
+//
+template <typename REAL> struct Rgemm_kernel {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    typedef REAL packed_t;
+    static constexpr int64_t packed_size = 1;
+    static int64_t mr() { return Rgemm_blocking<REAL>::MR; }
+    static int64_t nr() { return Rgemm_blocking<REAL>::NR; }
+    static void pack_a(int64_t const mc, int64_t const kc, REAL const *a, int64_t const rsa, int64_t const csa, int64_t const mr, packed_t *ap) { Rgemm_pack_a(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, REAL const *b, int64_t const rsb, int64_t const csb, int64_t const nr, packed_t *bp) { Rgemm_pack_b(kc, nc, b, rsb, csb, nr, bp); }
+    static void run(int64_t const kc, REAL const &alpha, REAL const *ap, REAL const *bp, REAL const &beta, REAL *c, int64_t const ldc, int64_t const mr, int64_t const nr) {
+        constexpr int64_t MR = Rgemm_blocking<REAL>::MR;
+        constexpr int64_t NR = Rgemm_blocking<REAL>::NR;
+        REAL ab[MR * NR];
+        for (int64_t p = 0; p < MR * NR; p++) {
+            ab[p] = 0.0;
+        }
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t j = 0; j < NR; j++) {
+                for (int64_t i = 0; i < MR; i++) {
+                    ab[i + j * MR] += ap[i] * bp[j];
+                }
+            }
+            ap += MR;
+            bp += NR;
+        }
+        const Mscalar ca = Mscalar_of(alpha);
+        const Mscalar cb = Mscalar_of(beta);
+        for (int64_t j = 0; j < nr; j++) {
+            for (int64_t i = 0; i < mr; i++) {
+                Rgemm_store(ca, alpha, ab[i + j * MR], cb, beta, c[i + j * ldc]);
+            }
+        }
+    }
+};
+
+//
+//     Register tiles the kernel of REAL can run with: list() gives the
+//     choices, use(mr, nr) switches to one of them and returns false if it is
+//     not offered.  use() must not be called while a product of REAL runs.
+//     Kernels with a fixed tile take this primary template.
+//
+template <typename REAL> struct Rgemm_shapes {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static std::vector<std::pair<int64_t, int64_t>> list() { return {{Rgemm_kernel<REAL>::mr(), Rgemm_kernel<REAL>::nr()}}; }
+    static bool use(int64_t const mr, int64_t const nr) { return (mr == Rgemm_kernel<REAL>::mr()) && (nr == Rgemm_kernel<REAL>::nr()); }
+};
+
+//
+//     Packing of op(A) and op(B) stored as TIN for the micro-kernel of REAL,
+//     as used by the mixed-precision Rgemm of Rgemm_mixed.hpp.  Elements are
+//     widened while they are packed, so only the packed panels are of the
+//     accumulation type.  Kernels whose packed form is not REAL itself
+//     specialize this.
+//
+template <typename TIN, typename REAL> struct Rgemm_widen {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    typedef typename Rgemm_kernel<REAL>::packed_t packed_t;
+    static void pack_a(int64_t const mc, int64_t const kc, TIN const *a, int64_t const rsa, int64_t const csa, int64_t const mr, packed_t *ap) {
+        if constexpr (std::is_same_v<TIN, REAL>) {
+            Rgemm_kernel<REAL>::pack_a(mc, kc, a, rsa, csa, mr, ap);
+        } else {
+            Rgemm_pack_a(mc, kc, a, rsa, csa, mr, ap);
+        }
+    }
+    static void pack_b(int64_t const kc, int64_t const nc, TIN const *b, int64_t const rsb, int64_t const csb, int64_t const nr, packed_t *bp) {
+        if constexpr (std::is_same_v<TIN, REAL>) {
+            Rgemm_kernel<REAL>::pack_b(kc, nc, b, rsb, csb, nr, bp);
+        } else {
+            Rgemm_pack_b(kc, nc, b, rsb, csb, nr, bp);
+        }
+    }
+};
+
+//
+//     Packing buffers of one thread.
+//
+template <typename PACKED> struct Rgemm_workspace {
+    Mbuffer<PACKED> apack;
+    Mbuffer<PACKED> bpack;
+    static Rgemm_workspace &local() {
+        thread_local Rgemm_workspace work;
+        return work;
+    }
+};
+
+template <typename REAL> bool Rgemm_use_blocked(int64_t const m, int64_t const n, int64_t const k) { return (m >= Rgemm_kernel<REAL>::mr()) && (n >= Rgemm_kernel<REAL>::nr()) && (m * n * k >= Rgemm_blocking<REAL>::threshold); }
+
+//
+//     C := beta*C.  zero and one are supplied by the caller so that a batch
+//     of products builds them only once.
+//
+template <typename T> void Rgemm_scale(int64_t const m, int64_t const n, T const &beta, T const &zero, T const &one, T *c, int64_t const ldc) {
+    int64_t i = 0;
+    int64_t j = 0;
+    if (beta == zero) {
+        for (j = 0; j < n; j++) {
+            for (i = 0; i < m; i++) {
+                c[i + j * ldc] = zero;
+            }
+        }
+    } else if (beta != one) {
+        for (j = 0; j < n; j++) {
+            for (i = 0; i < m; i++) {
+                c[i + j * ldc] = beta * c[i + j * ldc];
+            }
+        }
+    }
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C by the packed, blocked algorithm on the
+//     calling thread, with the packing buffers of that thread.  The micro-
+//     kernel applies beta to the first KC slice and adds the others.  A and
+//     B may be stored in a narrower type TIN; see Rgemm_widen.  zero and one
+//     are supplied by the caller, as for Rgemm_scale.
+//
+template <typename REAL, typename TIN = REAL> void Rgemm_update(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, TIN *a, int64_t const lda, TIN *b, int64_t const ldb, REAL const &beta, REAL const &zero, REAL const &one, REAL *c, int64_t const ldc) {
+    if ((m == 0) || (n == 0)) {
+        return;
+    }
+    if (k == 0) {
+        Rgemm_scale(m, n, beta, zero, one, c, ldc);
+        return;
+    }
+    //
+    //     Row and column strides of op(A) and op(B).
+    //
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csa = nota ? lda : 1;
+    const int64_t rsb = notb ? 1 : ldb;
+    const int64_t csb = notb ? ldb : 1;
+    const int64_t mr = Rgemm_kernel<REAL>::mr();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    int64_t MC = 0;
+    int64_t KC = 0;
+    int64_t NC = 0;
+    Rgemm_blocks<REAL>(mr, nr, MC, KC, NC);
+    const int64_t mcmax = std::min(MC, (m + mr - 1) / mr * mr);
+    const int64_t ncmax = std::min(NC, (n + nr - 1) / nr * nr);
+    const int64_t kcmax = std::min(KC, k);
+    const int64_t ps = Rgemm_kernel<REAL>::packed_size;
+    typedef typename Rgemm_kernel<REAL>::packed_t PACKED;
+    Rgemm_workspace<PACKED> &work = Rgemm_workspace<PACKED>::local();
+    PACKED *apack = work.apack.reserve(mcmax * kcmax * ps);
+    PACKED *bpack = work.bpack.reserve(kcmax * ncmax * ps);
+    for (int64_t jc = 0; jc < n; jc += NC) {
+        int64_t nc = std::min(NC, n - jc);
+        for (int64_t pc = 0; pc < k; pc += KC) {
+            int64_t kc = std::min(KC, k - pc);
+            REAL const &betapc = (pc == 0) ? beta : one;
+            Rgemm_widen<TIN, REAL>::pack_b(kc, nc, &b[pc * rsb + jc * csb], rsb, csb, nr, bpack);
+            for (int64_t ic = 0; ic < m; ic += MC) {
+                int64_t mc = std::min(MC, m - ic);
+                Rgemm_widen<TIN, REAL>::pack_a(mc, kc, &a[ic * rsa + pc * csa], rsa, csa, mr, apack);
+                for (int64_t jr = 0; jr < nc; jr += nr) {
+                    for (int64_t ir = 0; ir < mc; ir += mr) {
+                        Rgemm_kernel<REAL>::run(kc, alpha, &apack[ir * kc * ps], &bpack[jr * kc * ps], betapc, &c[(ic + ir) + (jc + jr) * ldc], ldc, std::min(mr, mc - ir), std::min(nr, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename REAL, typename TIN = REAL> void Rgemm_update(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, TIN *a, int64_t const lda, TIN *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    Rgemm_update(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, zero, one, c, ldc);
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C by the packed, blocked algorithm on the
+//     calling thread.  The arguments are those of Rgemm after validation.
+//
+template <typename REAL> void Rgemm_packed(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) { Rgemm_update(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc); }
+
+//
+//     C := alpha*op(A)*op(B) + beta*C by the packed, blocked algorithm.
+//     The arguments are those of Rgemm after validation; alpha is nonzero.
+//     C is cut into a 2-D grid of tiles aligned to the register tile, one or
+//     Rgemm_tasks_per_thread per OpenMP thread (Mparallel_tiles), and each
+//     tile runs Rgemm_packed on its own rows of op(A) and columns of op(B).
+//     The k loop is never split, so every element of C sees the same
+//     operations as in the serial run.
+//
+template <typename REAL> void Rgemm_blocked(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), m * n * std::max(k, (int64_t)1) / Rgemm_blocking<REAL>::work_per_thread);
+    if (nthreads <= 1) {
+        Rgemm_packed(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csb = notb ? ldb : 1;
+    const int64_t mr = Rgemm_kernel<REAL>::mr();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    Mparallel_tiles(m, n, mr, nr, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1) { Rgemm_packed(nota, notb, i1 - i0, j1 - j0, k, alpha, &a[i0 * rsa], lda, &b[j0 * csb], ldb, beta, &c[i0 + j0 * ldc], ldc); }, Rgemm_tasks_per_thread<REAL>());
+}
+} // namespace mpblas
+
+#include "Rgemm_simd.hpp"
+#include "Rgemm_qd.hpp"
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Rgemm and Rgemv for sizes known at compile time:
+  Rgemm_fixed<M, N, K, REAL, TA, TB>(alpha, a, lda, b, ldb, beta, c, ldc)
+      C := alpha*op(A)*op(B) + beta*C, C M x N, op(A) M x K, op(B) K x N
+  Rgemv_fixed<M, N, REAL, TRANS>(alpha, a, lda, x, incx, beta, y, incy)
+      y := alpha*op(A)*x + beta*y, A M x N
+The transpose modes default to Mtrans::N.  There is no argument checking and
+no Mxerbla: the sizes cannot be wrong, and the leading dimensions and
+increments are the caller's to get right (negative increments work as in
+Rgemv).  As in the BLAS, C and y are not read when beta is zero.
+A column of C (or all of y) is accumulated in a local array whose loops have
+constant trip counts; for the hardware types they are fully unrolled, so the
+accumulators live in (vector) registers.  For dd_real and qd_real the
+accumulators are separate doubles for each limb (hi/lo register pairs for
+dd_real) updated with the multiply-add of the blocked kernels
+(Rgemm_qd_lanes.hpp) rather than libqd objects; there the loops are left to
+the compiler, as unrolling them completely runs out of registers.  The
+elements are summed in a different order than in Rgemm and Rgemv, so the
+results may differ from theirs in the last bits.
+*/
+
+#ifndef ___MPBLAS_RGEMM_FIXED_H___
+#define ___MPBLAS_RGEMM_FIXED_H___
+
+#include <cstdint>
+#include <type_traits>
+#include "Mtrans.hpp"
+#include "Mtypes.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     The products for element type REAL; specialized for the libqd types
+//     in qd.hpp.
+//
+template <typename REAL> struct Rgemm_fixed_kernel {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    template <int M, int N, int K, Mtrans TA, Mtrans TB> static void gemm(REAL const &alpha, REAL const *a, int64_t const lda, REAL const *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+        const REAL zero = 0.0;
+        const bool betazero = (beta == zero);
+#pragma GCC unroll 64
+        for (int j = 0; j < N; j++) {
+            REAL acc[M];
+#pragma GCC unroll 64
+            for (int i = 0; i < M; i++) {
+                acc[i] = zero;
+            }
+#pragma GCC unroll 64
+            for (int l = 0; l < K; l++) {
+                const REAL blj = (TB == Mtrans::N) ? b[l + j * ldb] : b[j + l * ldb];
+#pragma GCC unroll 64
+                for (int i = 0; i < M; i++) {
+                    acc[i] += ((TA == Mtrans::N) ? a[i + l * lda] : a[l + i * lda]) * blj;
+                }
+            }
+            if (betazero) {
+#pragma GCC unroll 64
+                for (int i = 0; i < M; i++) {
+                    c[i + j * ldc] = alpha * acc[i];
+                }
+            } else {
+#pragma GCC unroll 64
+                for (int i = 0; i < M; i++) {
+                    c[i + j * ldc] = alpha * acc[i] + beta * c[i + j * ldc];
+                }
+            }
+        }
+    }
+
+    //
+    //     x and y point at their first elements in storage order.
+    //
+    template <int M, int N, Mtrans TRANS> static void gemv(REAL const &alpha, REAL const *a, int64_t const lda, REAL const *x, int64_t const incx, REAL const &beta, REAL *y, int64_t const incy) {
+        const REAL zero = 0.0;
+        constexpr int LENY = (TRANS == Mtrans::N) ? M : N;
+        REAL acc[LENY];
+        if constexpr (TRANS == Mtrans::N) {
+#pragma GCC unroll 64
+            for (int i = 0; i < M; i++) {
+                acc[i] = zero;
+            }
+#pragma GCC unroll 64
+            for (int j = 0; j < N; j++) {
+                const REAL xj = x[j * incx];
+#pragma GCC unroll 64
+                for (int i = 0; i < M; i++) {
+                    acc[i] += a[i + j * lda] * xj;
+                }
+            }
+        } else {
+#pragma GCC unroll 64
+            for (int j = 0; j < N; j++) {
+                REAL temp = zero;
+#pragma GCC unroll 64
+                for (int i = 0; i < M; i++) {
+                    temp += a[i + j * lda] * x[i * incx];
+                }
+                acc[j] = temp;
+            }
+        }
+        if (beta == zero) {
+#pragma GCC unroll 64
+            for (int i = 0; i < LENY; i++) {
+                y[i * incy] = alpha * acc[i];
+            }
+        } else {
+#pragma GCC unroll 64
+            for (int i = 0; i < LENY; i++) {
+                y[i * incy] = alpha * acc[i] + beta * y[i * incy];
+            }
+        }
+    }
+};
+
+//
+//     A libqd type with LIMBS doubles: acc[i][t] is limb t of accumulator i,
+//     and every element is split into its limbs before the multiply-add.
+//
+template <typename REAL, int LIMBS> struct Rgemm_fixed_limbs {
+    static void load(REAL const &x, double *l) {
+        for (int t = 0; t < LIMBS; t++) {
+            l[t] = x.x[t];
+        }
+    }
+    static void madd(double const *a, double const *b, double *c) {
+        if constexpr (LIMBS == 2) {
+            Rgemm_qd_scalar::dd_madd(a[0], a[1], b[0], b[1], c[0], c[1]);
+        } else {
+            Rgemm_qd_scalar::qd_madd(a, b, c);
+        }
+    }
+    static REAL value(double const *l) {
+        REAL x;
+        for (int t = 0; t < LIMBS; t++) {
+            x.x[t] = l[t];
+        }
+        return x;
+    }
+    static void store(REAL const &alpha, REAL const &beta, bool const betazero, double const *l, REAL &y) {
+        if (betazero) {
+            y = alpha * value(l);
+        } else {
+            y = alpha * value(l) + beta * y;
+        }
+    }
+
+    template <int M, int N, int K, Mtrans TA, Mtrans TB> static void gemm(REAL const &alpha, REAL const *a, int64_t const lda, REAL const *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+        const REAL zero = 0.0;
+        const bool betazero = (beta == zero);
+        for (int j = 0; j < N; j++) {
+            double acc[M][LIMBS] = {};
+            for (int l = 0; l < K; l++) {
+                double bl[LIMBS];
+                load((TB == Mtrans::N) ? b[l + j * ldb] : b[j + l * ldb], bl);
+                for (int i = 0; i < M; i++) {
+                    double al[LIMBS];
+                    load((TA == Mtrans::N) ? a[i + l * lda] : a[l + i * lda], al);
+                    madd(al, bl, acc[i]);
+                }
+            }
+            for (int i = 0; i < M; i++) {
+                store(alpha, beta, betazero, acc[i], c[i + j * ldc]);
+            }
+        }
+    }
+
+    template <int M, int N, Mtrans TRANS> static void gemv(REAL const &alpha, REAL const *a, int64_t const lda, REAL const *x, int64_t const incx, REAL const &beta, REAL *y, int64_t const incy) {
+        const REAL zero = 0.0;
+        const bool betazero = (beta == zero);
+        if constexpr (TRANS == Mtrans::N) {
+            double acc[M][LIMBS] = {};
+            for (int j = 0; j < N; j++) {
+                double xl[LIMBS];
+                load(x[j * incx], xl);
+                for (int i = 0; i < M; i++) {
+                    double al[LIMBS];
+                    load(a[i + j * lda], al);
+                    madd(al, xl, acc[i]);
+                }
+            }
+            for (int i = 0; i < M; i++) {
+                store(alpha, beta, betazero, acc[i], y[i * incy]);
+            }
+        } else {
+            for (int j = 0; j < N; j++) {
+                double temp[LIMBS] = {};
+                for (int i = 0; i < M; i++) {
+                    double al[LIMBS];
+                    double xl[LIMBS];
+                    load(a[i + j * lda], al);
+                    load(x[i * incx], xl);
+                    madd(al, xl, temp);
+                }
+                store(alpha, beta, betazero, temp, y[j * incy]);
+            }
+        }
+    }
+};
+
+template <int M, int N, int K, typename REAL, Mtrans TA = Mtrans::N, Mtrans TB = Mtrans::N> void Rgemm_fixed(std::type_identity_t<REAL> const &alpha, REAL const *a, int64_t const lda, REAL const *b, int64_t const ldb, std::type_identity_t<REAL> const &beta, REAL *c, int64_t const ldc) {
+    static_assert((M > 0) && (N > 0) && (K > 0), "Rgemm_fixed: the sizes must be positive");
+    Rgemm_fixed_kernel<REAL>::template gemm<M, N, K, TA, TB>(alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+template <int M, int N, typename REAL, Mtrans TRANS = Mtrans::N> void Rgemv_fixed(std::type_identity_t<REAL> const &alpha, REAL const *a, int64_t const lda, REAL const *x, int64_t const incx, std::type_identity_t<REAL> const &beta, REAL *y, int64_t const incy) {
+    static_assert((M > 0) && (N > 0), "Rgemv_fixed: the sizes must be positive");
+    constexpr int64_t lenx = (TRANS == Mtrans::N) ? N : M;
+    constexpr int64_t leny = (TRANS == Mtrans::N) ? M : N;
+    REAL const *x0 = (incx > 0) ? x : x - (lenx - 1) * incx;
+    REAL *y0 = (incy > 0) ? y : y - (leny - 1) * incy;
+    Rgemm_fixed_kernel<REAL>::template gemv<M, N, (TRANS == Mtrans::N) ? Mtrans::N : Mtrans::T>(alpha, a, lda, x0, incx, beta, y0, incy);
+}
+} // namespace mpblas
+
+#endif
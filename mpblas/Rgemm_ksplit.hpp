@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Rgemm with the k dimension split, for small C and long k (a 16 x 16 Gram
+matrix of vectors of length 10^6 is a single tile for Rgemm_blocked, so one
+thread).  k is cut into P slices whose bounds are multiples of KC, every
+slice s forms the partial product W_s = op(A)(:, slice) * op(B)(slice, :)
+with Rgemm_packed in a private m x n array, and the partials are added by a
+pairwise tree of fixed shape,
+    W_0 + W_1, W_2 + W_3, ...; (W_0 + W_1) + (W_2 + W_3), ...
+before C := alpha*W + beta*C.  P depends on m, n and k only, and any thread
+may form any slice, so the result does not depend on the number of threads
+or on the schedule.  It differs in the last bits from Rgemm_blocked's, which
+sums the KC blocks left to right.
+*/
+
+#ifndef ___MPBLAS_RGEMM_KSPLIT_H___
+#define ___MPBLAS_RGEMM_KSPLIT_H___
+
+#include <algorithm>
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Mscheduler.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     At most max_parts slices; each is at least KC long and has at least
+//     work_per_thread multiply-adds.
+//
+template <typename REAL> struct Rgemm_ksplit_traits {
+    static constexpr int64_t max_parts = 64;
+};
+
+template <typename REAL> int64_t Rgemm_ksplit_parts(int64_t const m, int64_t const n, int64_t const k) {
+    int64_t MC = 0;
+    int64_t KC = 0;
+    int64_t NC = 0;
+    Rgemm_blocks<REAL>(Rgemm_kernel<REAL>::mr(), Rgemm_kernel<REAL>::nr(), MC, KC, NC);
+    const int64_t kmin = std::max(KC, Rgemm_blocking<REAL>::work_per_thread / std::max(m * n, (int64_t)1));
+    return std::max((int64_t)1, std::min(Rgemm_ksplit_traits<REAL>::max_parts, k / kmin));
+}
+
+//
+//     Split k when Rgemm_blocked would leave threads idle: C has fewer
+//     register tiles than there are threads, and k is long enough for two
+//     slices.
+//
+template <typename REAL> bool Rgemm_use_ksplit(int64_t const m, int64_t const n, int64_t const k) {
+    const int64_t nthreads = Mnum_threads();
+    if (nthreads <= 1) {
+        return false;
+    }
+    const int64_t mr = Rgemm_kernel<REAL>::mr();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    const int64_t tiles = ((m + mr - 1) / mr) * ((n + nr - 1) / nr);
+    return (tiles < nthreads) && (Rgemm_ksplit_parts<REAL>(m, n, k) >= 2);
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C.  The arguments are those of Rgemm after
+//     validation; alpha is nonzero.
+//
+template <typename REAL> void Rgemm_ksplit(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    const int64_t parts = Rgemm_ksplit_parts<REAL>(m, n, k);
+    const int64_t csa = nota ? lda : 1;
+    const int64_t rsb = notb ? 1 : ldb;
+    int64_t MC = 0;
+    int64_t KC = 0;
+    int64_t NC = 0;
+    Rgemm_blocks<REAL>(Rgemm_kernel<REAL>::mr(), Rgemm_kernel<REAL>::nr(), MC, KC, NC);
+    const int64_t mn = m * n;
+    thread_local Mbuffer<REAL> buffer;
+    REAL *w = buffer.reserve(parts * mn);
+    //
+    //     The partial products, W_s at w + s*m*n with leading dimension m.
+    //
+    Mparallel_tasks(parts, Mnum_threads(), [&](int64_t const s) {
+        const int64_t l0 = Mtile_start(s, parts, k, KC);
+        const int64_t l1 = Mtile_start(s + 1, parts, k, KC);
+        Rgemm_packed(nota, notb, m, n, l1 - l0, one, &a[l0 * csa], lda, &b[l0 * rsb], ldb, zero, &w[s * mn], m);
+    });
+    //
+    //     The tree, element by element, and the update of C; C is not read
+    //     when beta is zero.
+    //
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), parts * mn / Rgemm_blocking<REAL>::work_per_thread + 1);
+    Mparallel_tiles(m, n, 1, 1, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1) {
+        for (int64_t j = j0; j < j1; j++) {
+            for (int64_t i = i0; i < i1; i++) {
+                const int64_t e = i + j * m;
+                for (int64_t step = 1; step < parts; step *= 2) {
+                    for (int64_t s = 0; s + step < parts; s += 2 * step) {
+                        w[s * mn + e] += w[(s + step) * mn + e];
+                    }
+                }
+                if (beta == zero) {
+                    c[i + j * ldc] = alpha * w[e];
+                } else {
+                    c[i + j * ldc] = alpha * w[e] + beta * c[i + j * ldc];
+                }
+            }
+        }
+    });
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Mixed-precision Rgemm: C := alpha*op(A)*op(B) + beta*C with A and B stored as
+TIN, the products accumulated in TACC and C stored as TOUT, e.g.
+    Rgemm<double, dd_real, double>(...)
+    Rgemm<_Float16, float, _Float16>(...)
+A and B are widened to TACC while they are packed for the micro-kernel of
+TACC, so they are read from memory at their storage width.  When TOUT is not
+TACC, each thread holds one MC x NC block of C in TACC at a time: the block is
+converted to TACC once, the whole k loop runs on it and it is rounded back
+once, so the wide copy of C never grows past one block.  alpha and beta are of type TACC.  The products
+always run on the blocked engine; the parallel results are bitwise identical
+to the serial ones, as in Rgemm_blocked.
+*/
+
+#ifndef ___MPBLAS_RGEMM_MIXED_H___
+#define ___MPBLAS_RGEMM_MIXED_H___
+
+#include <type_traits>
+#include "Mtrans.hpp"
+#include "Mxerbla.hpp"
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     x rounded (or widened) to TOUT.  A libqd value without a conversion to
+//     TOUT is summed limb by limb in TOUT, smallest first; mpf_class goes
+//     through double (get_d()).
+//
+template <typename TOUT, typename TACC> TOUT Rgemm_mixed_cast(TACC const &x) {
+    if constexpr (std::is_constructible_v<TOUT, TACC const &>) {
+        return TOUT(x);
+    } else if constexpr (requires { x.x[0]; }) {
+        constexpr int64_t limbs = sizeof(x.x) / sizeof(x.x[0]);
+        TOUT r = TOUT(x.x[limbs - 1]);
+        for (int64_t t = limbs - 2; t >= 0; t--) {
+            r += x.x[t];
+        }
+        return r;
+    } else {
+        return TOUT(x.get_d());
+    }
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C on the calling thread.  When TOUT is
+//     not TACC, the blocked loops of Rgemm_update are reordered so that the
+//     whole k loop of one MC x NC block of C runs before the next block: the
+//     block is held in TACC in a buffer of that size, read from C once
+//     (unless beta is zero) and rounded to TOUT once.  The KC x NC slice of
+//     op(B) is packed again for every block of rows, which costs one pass
+//     over B per MC rows of C.
+//
+template <typename TIN, typename TACC, typename TOUT> void Rgemm_mixed_packed(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, TACC const &alpha, TIN *a, int64_t const lda, TIN *b, int64_t const ldb, TACC const &beta, TOUT *c, int64_t const ldc) {
+    if constexpr (std::is_same_v<TACC, TOUT>) {
+        Rgemm_update(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    } else {
+        const TACC zero = 0.0;
+        const TACC one = 1.0;
+        const bool betazero = (beta == zero);
+        int64_t i = 0;
+        int64_t j = 0;
+        if ((m == 0) || (n == 0)) {
+            return;
+        }
+        if (k == 0) {
+            for (j = 0; j < n; j++) {
+                for (i = 0; i < m; i++) {
+                    c[i + j * ldc] = betazero ? Rgemm_mixed_cast<TOUT>(zero) : Rgemm_mixed_cast<TOUT>(TACC(beta * Rgemm_mixed_cast<TACC>(c[i + j * ldc])));
+                }
+            }
+            return;
+        }
+        const int64_t rsa = nota ? 1 : lda;
+        const int64_t csa = nota ? lda : 1;
+        const int64_t rsb = notb ? 1 : ldb;
+        const int64_t csb = notb ? ldb : 1;
+        const int64_t mr = Rgemm_kernel<TACC>::mr();
+        const int64_t nr = Rgemm_kernel<TACC>::nr();
+        int64_t MC = 0;
+        int64_t KC = 0;
+        int64_t NC = 0;
+        Rgemm_blocks<TACC>(mr, nr, MC, KC, NC);
+        const int64_t mcmax = std::min(MC, (m + mr - 1) / mr * mr);
+        const int64_t ncmax = std::min(NC, (n + nr - 1) / nr * nr);
+        const int64_t kcmax = std::min(KC, k);
+        const int64_t ps = Rgemm_kernel<TACC>::packed_size;
+        typedef typename Rgemm_kernel<TACC>::packed_t PACKED;
+        Rgemm_workspace<PACKED> &work = Rgemm_workspace<PACKED>::local();
+        PACKED *apack = work.apack.reserve(mcmax * kcmax * ps);
+        PACKED *bpack = work.bpack.reserve(kcmax * ncmax * ps);
+        thread_local Mbuffer<TACC> acc;
+        TACC *w = acc.reserve(mcmax * ncmax);
+        for (int64_t jc = 0; jc < n; jc += NC) {
+            int64_t nc = std::min(NC, n - jc);
+            for (int64_t ic = 0; ic < m; ic += MC) {
+                int64_t mc = std::min(MC, m - ic);
+                TOUT *cb = &c[ic + jc * ldc];
+                if (!betazero) {
+                    for (j = 0; j < nc; j++) {
+                        for (i = 0; i < mc; i++) {
+                            w[i + j * mc] = Rgemm_mixed_cast<TACC>(cb[i + j * ldc]);
+                        }
+                    }
+                }
+                for (int64_t pc = 0; pc < k; pc += KC) {
+                    int64_t kc = std::min(KC, k - pc);
+                    TACC const &betapc = (pc == 0) ? beta : one;
+                    Rgemm_widen<TIN, TACC>::pack_b(kc, nc, &b[pc * rsb + jc * csb], rsb, csb, nr, bpack);
+                    Rgemm_widen<TIN, TACC>::pack_a(mc, kc, &a[ic * rsa + pc * csa], rsa, csa, mr, apack);
+                    for (int64_t jr = 0; jr < nc; jr += nr) {
+                        for (int64_t ir = 0; ir < mc; ir += mr) {
+                            Rgemm_kernel<TACC>::run(kc, alpha, &apack[ir * kc * ps], &bpack[jr * kc * ps], betapc, &w[ir + jr * mc], mc, std::min(mr, mc - ir), std::min(nr, nc - jr));
+                        }
+                    }
+                }
+                for (j = 0; j < nc; j++) {
+                    for (i = 0; i < mc; i++) {
+                        cb[i + j * ldc] = Rgemm_mixed_cast<TOUT>(w[i + j * mc]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+//     Rgemm_mixed_packed on a 2-D grid of tiles of C aligned to the register
+//     tile of TACC, one or Rgemm_tasks_per_thread<TACC> per OpenMP thread.
+//
+template <typename TIN, typename TACC, typename TOUT> void Rgemm_mixed_blocked(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, TACC const &alpha, TIN *a, int64_t const lda, TIN *b, int64_t const ldb, TACC const &beta, TOUT *c, int64_t const ldc) {
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), m * n * std::max(k, (int64_t)1) / Rgemm_blocking<TACC>::work_per_thread);
+    if (nthreads <= 1) {
+        Rgemm_mixed_packed(nota, notb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csb = notb ? ldb : 1;
+    const int64_t mr = Rgemm_kernel<TACC>::mr();
+    const int64_t nr = Rgemm_kernel<TACC>::nr();
+    Mparallel_tiles(m, n, mr, nr, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1) { Rgemm_mixed_packed(nota, notb, i1 - i0, j1 - j0, k, alpha, &a[i0 * rsa], lda, &b[j0 * csb], ldb, beta, &c[i0 + j0 * ldc], ldc); }, Rgemm_tasks_per_thread<TACC>());
+}
+
+//
+//     TACC and TOUT are never deduced, so Rgemm<REAL>(...) always means the
+//     single-type Rgemm of Rgemm.hpp.
+//
+template <typename TIN, typename TACC, typename TOUT> void Rgemm(const char *transa, const char *transb, int64_t const m, int64_t const n, int64_t const k, std::type_identity_t<TACC> const &alpha, TIN *a, int64_t const lda, TIN *b, int64_t const ldb, std::type_identity_t<TACC> const &beta, std::type_identity_t<TOUT> *c, int64_t const ldc) {
+    Mtrans ta = Mtrans::N;
+    Mtrans tb = Mtrans::N;
+    if (!Mtrans_parse(transa, ta)) {
+        Mxerbla("Rgemm ", 1);
+        return;
+    }
+    if (!Mtrans_parse(transb, tb)) {
+        Mxerbla("Rgemm ", 2);
+        return;
+    }
+    bool nota = (ta == Mtrans::N);
+    bool notb = (tb == Mtrans::N);
+    int64_t nrowa = nota ? m : k;
+    int64_t nrowb = notb ? k : n;
+    //
+    //     Test the other input parameters.
+    //
+    int64_t info = 0;
+    if (m < 0) {
+        info = 3;
+    } else if (n < 0) {
+        info = 4;
+    } else if (k < 0) {
+        info = 5;
+    } else if (lda < std::max((int64_t)1, nrowa)) {
+        info = 8;
+    } else if (ldb < std::max((int64_t)1, nrowb)) {
+        info = 10;
+    } else if (ldc < std::max((int64_t)1, m)) {
+        info = 13;
+    }
+    if (info != 0) {
+        Mxerbla("Rgemm ", info);
+        return;
+    }
+    //
+    //     Quick return if possible.  With alpha = 0 only C := beta*C is left.
+    //
+    const TACC zero = 0.0;
+    const TACC one = 1.0;
+    if ((m == 0) || (n == 0) || (((alpha == zero) || (k == 0)) && (beta == one))) {
+        return;
+    }
+    Rgemm_mixed_blocked<TIN, TACC, TOUT>(nota, notb, m, n, (alpha == zero) ? 0 : k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+} // namespace mpblas
+
+#endif
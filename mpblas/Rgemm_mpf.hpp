@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Rgemm micro-kernel for mpf_class (gmpxx).
+gmpxx evaluates every expression such as temp * a[...] into a temporary that
+is created with mpf_init and destroyed with mpf_clear, i.e. two trips to the
+allocator per multiply-add.  Here the tile accumulators live in per-thread
+mpf_t scratch and the inner loop calls mpf_mul/mpf_add directly, so no memory
+is allocated once the scratch and the packing buffers have been set up.
+This header is included by gmp.hpp.
+*/
+
+#ifndef ___MPBLAS_RGEMM_MPF_H___
+#define ___MPBLAS_RGEMM_MPF_H___
+
+#include <vector>
+#include <gmpxx.h>
+#include "Mbuffer.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     mpf_t scratch of one thread, at the current default precision.  The
+//     variables are kept until the thread exits; a change of the default
+//     precision resets them at the next get().
+//
+struct Mmpf_scratch {
+    std::vector<__mpf_struct> v;
+    mp_bitcnt_t prec = 0;
+    ~Mmpf_scratch() {
+        for (__mpf_struct &x : v) {
+            mpf_clear(&x);
+        }
+    }
+    mpf_ptr get(int64_t const count) {
+        mp_bitcnt_t p = mpf_get_default_prec();
+        if (p != prec) {
+            for (__mpf_struct &x : v) {
+                mpf_set_prec(&x, p);
+            }
+            prec = p;
+        }
+        while ((int64_t)v.size() < count) {
+            v.emplace_back();
+            mpf_init2(&v.back(), p);
+        }
+        return v.data();
+    }
+    static Mmpf_scratch &local() {
+        thread_local Mmpf_scratch scratch;
+        return scratch;
+    }
+};
+
+//
+//     Buffers of mpf_class (the packing buffers, for instance) keep the
+//     precision their elements were created with; rebuild them when the
+//     default precision changes.
+//
+template <> struct Mbuffer_format<mpf_class> {
+    static uint64_t current() { return mpf_get_default_prec(); }
+};
+
+template <> struct Rgemm_kernel<mpf_class> {
+    typedef mpf_class packed_t;
+    static constexpr int64_t packed_size = 1;
+    static int64_t mr() { return Rgemm_blocking<mpf_class>::MR; }
+    static int64_t nr() { return Rgemm_blocking<mpf_class>::NR; }
+    static void pack_a(int64_t const mc, int64_t const kc, mpf_class const *a, int64_t const rsa, int64_t const csa, int64_t const mr, mpf_class *ap) { Rgemm_pack_a(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, mpf_class const *b, int64_t const rsb, int64_t const csb, int64_t const nr, mpf_class *bp) { Rgemm_pack_b(kc, nc, b, rsb, csb, nr, bp); }
+    static void run(int64_t const kc, mpf_class const &alpha, mpf_class const *ap, mpf_class const *bp, mpf_class const &beta, mpf_class *c, int64_t const ldc, int64_t const mr, int64_t const nr) {
+        constexpr int64_t MR = Rgemm_blocking<mpf_class>::MR;
+        constexpr int64_t NR = Rgemm_blocking<mpf_class>::NR;
+        mpf_ptr ab = Mmpf_scratch::local().get(MR * NR + 1);
+        mpf_ptr tmp = &ab[MR * NR];
+        for (int64_t p = 0; p < MR * NR; p++) {
+            mpf_set_ui(&ab[p], 0);
+        }
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t j = 0; j < NR; j++) {
+                mpf_srcptr bj = bp[j].get_mpf_t();
+                for (int64_t i = 0; i < MR; i++) {
+                    mpf_mul(tmp, ap[i].get_mpf_t(), bj);
+                    mpf_add(&ab[i + j * MR], &ab[i + j * MR], tmp);
+                }
+            }
+            ap += MR;
+            bp += NR;
+        }
+        //
+        //     C := alpha*AB + beta*C without reading C when beta is zero and
+        //     without multiplying by an alpha or beta of one.
+        //
+        const bool alphaone = (mpf_cmp_ui(alpha.get_mpf_t(), 1) == 0);
+        const Mscalar cb = (mpf_sgn(beta.get_mpf_t()) == 0) ? Mscalar::zero : ((mpf_cmp_ui(beta.get_mpf_t(), 1) == 0) ? Mscalar::one : Mscalar::general);
+        for (int64_t j = 0; j < nr; j++) {
+            for (int64_t i = 0; i < mr; i++) {
+                mpf_ptr cij = c[i + j * ldc].get_mpf_t();
+                mpf_srcptr x = &ab[i + j * MR];
+                if (!alphaone) {
+                    mpf_mul(tmp, alpha.get_mpf_t(), x);
+                    x = tmp;
+                }
+                if (cb == Mscalar::zero) {
+                    mpf_set(cij, x);
+                } else if (cb == Mscalar::one) {
+                    mpf_add(cij, cij, x);
+                } else {
+                    mpf_mul(cij, beta.get_mpf_t(), cij);
+                    mpf_add(cij, cij, x);
+                }
+            }
+        }
+    }
+};
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Rgemm by the Ozaki scheme, for dd_real, qd_real, _Float128 and mpf_class.
+Each row of op(A) (column of op(B)) is scaled by a power of two and split
+without error into S slices of small integers held in doubles,
+    op(A)(i, :) = 2^(E_i - beta) * sum_s 2^(-beta * s) * A_s(i, :),
+with beta chosen so that every product of slices, summed over k and over the
+slices of one level, is an exact integer below 2^53.  The slice products are
+then ordinary double GEMMs on the blocked engine, and only their sum, level by
+level, is formed in the target precision: O(n^3) hardware operations plus
+O(S n^2) operations on REAL.  Products below the target precision
+(level >= S) are dropped.
+The error is bounded in terms of the largest element of each row of op(A) and
+column of op(B) rather than elementwise, which is why the method is only used
+when asked for with Mgemm_algo::ozaki.
+*/
+
+#ifndef ___MPBLAS_RGEMM_OZAKI_H___
+#define ___MPBLAS_RGEMM_OZAKI_H___
+
+#include <climits>
+#include <cmath>
+#include "Mtypes.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     Element access for the scheme.  A type is enabled by a specialization
+//     providing
+//       digits()         bits of precision to reproduce,
+//       exponent(x)      e with |x| <= 2^e (INT_MIN for zero),
+//       scale(x, e)      x := x * 2^e, exactly,
+//       add(x, d)        x := x + d for a double d,
+//       split(x, e, beta, S, out, stride)
+//                        the S slices of x * 2^(beta - e) into out[s * stride].
+//
+template <typename REAL> struct Rgemm_ozaki_traits {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static constexpr bool enabled = false;
+};
+
+//
+//     Binary floating point types whose leading part is a double (approx).
+//
+template <typename REAL, typename APPROX> struct Rgemm_ozaki_binary {
+    static constexpr bool enabled = true;
+    static int exponent(REAL const &x) {
+        double d = APPROX::approx(x);
+        if (d == 0.0) {
+            return INT_MIN;
+        }
+        int e;
+        std::frexp(d, &e);
+        return e;
+    }
+    static void add(REAL &x, double const d) { x += d; }
+    static void split(REAL const &x, int const e, int const beta, int64_t const S, double *out, int64_t const stride) {
+        REAL r = x;
+        APPROX::scale(r, beta - e);
+        for (int64_t s = 0; s < S; s++) {
+            double slice = std::nearbyint(APPROX::approx(r));
+            out[s * stride] = slice;
+            r -= slice;
+            APPROX::scale(r, beta);
+        }
+    }
+};
+
+#ifdef __FLT128_MANT_DIG__
+template <> struct Rgemm_ozaki_traits<_Float128> : Rgemm_ozaki_binary<_Float128, Rgemm_ozaki_traits<_Float128>> {
+    static int digits() { return __FLT128_MANT_DIG__; }
+    static double approx(_Float128 const &x) { return (double)x; }
+    //
+    //     The range of _Float128 exceeds that of double: bring |x| into
+    //     [2^-960, 2^960) by powers of two before it is converted.
+    //
+    static int exponent(_Float128 const &x) {
+        if (x == 0) {
+            return INT_MIN;
+        }
+        _Float128 r = (x < 0) ? -x : x;
+        int e = 0;
+        const _Float128 big = std::ldexp(1.0, 960);
+        const _Float128 small = std::ldexp(1.0, -960);
+        for (; r >= big; e += 960) {
+            r *= small;
+        }
+        for (; r < small; e -= 960) {
+            r *= big;
+        }
+        int f;
+        std::frexp((double)r, &f);
+        return e + f;
+    }
+    static void scale(_Float128 &x, int e) {
+        for (; e > 960; e -= 960) {
+            x *= std::ldexp(1.0, 960);
+        }
+        for (; e < -960; e += 960) {
+            x *= std::ldexp(1.0, -960);
+        }
+        x *= std::ldexp(1.0, e);
+    }
+};
+#endif
+
+//
+//     A libqd type of LIMBS doubles with DIGITS bits of precision.
+//
+template <typename REAL, int LIMBS, int DIGITS> struct Rgemm_ozaki_limbs : Rgemm_ozaki_binary<REAL, Rgemm_ozaki_limbs<REAL, LIMBS, DIGITS>> {
+    static int digits() { return DIGITS; }
+    static double approx(REAL const &x) { return x.x[0]; }
+    static void scale(REAL &x, int const e) {
+        for (int t = 0; t < LIMBS; t++) {
+            x.x[t] = std::ldexp(x.x[t], e);
+        }
+    }
+};
+
+//
+//     Slice width beta and number of slices S for inner dimension k: S levels
+//     of k products of slices bounded by 2^beta must stay exact, i.e.
+//     k * S * 2^(2 beta) <= 2^53.
+//
+inline void Rgemm_ozaki_slices(int64_t const k, int const digits, int &beta, int64_t &S) {
+    S = 1;
+    for (int iter = 0; iter < 4; iter++) {
+        int bits = 0;
+        while (((int64_t)1 << bits) < std::max(k, (int64_t)1) * S) {
+            bits++;
+        }
+        beta = std::max(1, (53 - bits) / 2);
+        S = (digits + beta - 1) / beta + 1;
+    }
+}
+
+template <typename REAL> void Rgemm_ozaki(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    typedef Rgemm_ozaki_traits<REAL> traits;
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    for (int64_t j = 0; j < n; j++) {
+        if (beta == zero) {
+            for (int64_t i = 0; i < m; i++) {
+                c[i + j * ldc] = zero;
+            }
+        } else if (beta != one) {
+            for (int64_t i = 0; i < m; i++) {
+                c[i + j * ldc] = beta * c[i + j * ldc];
+            }
+        }
+    }
+    if (k == 0) {
+        return;
+    }
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csa = nota ? lda : 1;
+    const int64_t rsb = notb ? 1 : ldb;
+    const int64_t csb = notb ? ldb : 1;
+    int w = 0;
+    int64_t S = 0;
+    Rgemm_ozaki_slices(k, traits::digits(), w, S);
+    //
+    //     Row exponents of op(A), column exponents of op(B), and the slices:
+    //     A_s is m x k at as[s * m * k], B_s is k x n at bs[s * k * n].
+    //
+    std::vector<int> ea(m);
+    std::vector<int> eb(n);
+    std::vector<double> as(S * m * k);
+    std::vector<double> bs(S * k * n);
+    const int threads = Mnum_threads();
+#pragma omp parallel for schedule(static) num_threads(threads)
+    for (int64_t i = 0; i < m; i++) {
+        int e = INT_MIN;
+        for (int64_t l = 0; l < k; l++) {
+            e = std::max(e, traits::exponent(a[i * rsa + l * csa]));
+        }
+        ea[i] = (e == INT_MIN) ? 0 : e;
+        for (int64_t l = 0; l < k; l++) {
+            traits::split(a[i * rsa + l * csa], ea[i], w, S, &as[i + l * m], m * k);
+        }
+    }
+#pragma omp parallel for schedule(static) num_threads(threads)
+    for (int64_t j = 0; j < n; j++) {
+        int e = INT_MIN;
+        for (int64_t l = 0; l < k; l++) {
+            e = std::max(e, traits::exponent(b[l * rsb + j * csb]));
+        }
+        eb[j] = (e == INT_MIN) ? 0 : e;
+        for (int64_t l = 0; l < k; l++) {
+            traits::split(b[l * rsb + j * csb], eb[j], w, S, &bs[l + j * k], k * n);
+        }
+    }
+    //
+    //     Levels d = S-1, ..., 0: P = sum_{s+t=d} A_s * B_t in double, folded
+    //     into acc by Horner's rule, acc := acc * 2^(-beta) + P.
+    //
+    std::vector<double> p(m * n);
+    std::vector<REAL> acc(m * n);
+    for (int64_t d = S - 1; d >= 0; d--) {
+        for (int64_t s = 0; s <= d; s++) {
+            Rgemm_blocked(true, true, m, n, k, 1.0, &as[s * m * k], m, &bs[(d - s) * k * n], k, (s == 0) ? 0.0 : 1.0, p.data(), m);
+        }
+#pragma omp parallel for schedule(static) num_threads(threads)
+        for (int64_t j = 0; j < n; j++) {
+            for (int64_t i = 0; i < m; i++) {
+                if (d != S - 1) {
+                    traits::scale(acc[i + j * m], -w);
+                }
+                traits::add(acc[i + j * m], p[i + j * m]);
+            }
+        }
+    }
+    //
+    //     C := C + alpha * 2^(E_i + F_j - 2 beta) * acc.
+    //
+#pragma omp parallel for schedule(static) num_threads(threads)
+    for (int64_t j = 0; j < n; j++) {
+        for (int64_t i = 0; i < m; i++) {
+            REAL &x = acc[i + j * m];
+            traits::scale(x, ea[i] + eb[j] - 2 * w);
+            c[i + j * ldc] += alpha * x;
+        }
+    }
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Rgemm micro-kernels for dd_real and qd_real (libqd), and the "N" Rgemv
+kernel of Rgemv_blocked.hpp.
+Panels are packed into split limb arrays (hi[], lo[], ...) and the kernels in
+Rgemm_qd_lanes.hpp run the error-free transformations on 8 (AVX-512F), 4
+(AVX2+FMA) or 1 (scalar) C entries per instruction; the set is chosen once at
+run time.  The tile is stored to C with libqd's own arithmetic.  The
+vector sections are compiled without contracting a * b + c into a fused
+multiply-add, so every lane rounds as libqd does.
+Nothing here depends on libqd itself; qd.hpp makes these kernels those of
+dd_real and qd_real.
+*/
+
+#ifndef ___MPBLAS_RGEMM_QD_H___
+#define ___MPBLAS_RGEMM_QD_H___
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+namespace mpblas {
+
+namespace Rgemm_qd_scalar {
+typedef double V;
+constexpr int64_t L = 1;
+inline V vzero() { return 0.0; }
+inline V vload(double const *p) { return *p; }
+inline V vbroadcast(double const *p) { return *p; }
+inline void vstore(double *p, V v) { *p = v; }
+inline V vfms(V a, V b, V c) { return std::fma(a, b, -c); }
+inline void vsplit(V a, V b, V &even, V &odd) {
+    even = a;
+    odd = b;
+}
+inline void vmerge(V even, V odd, V &a, V &b) {
+    a = even;
+    b = odd;
+}
+#include "Rgemm_qd_lanes.hpp"
+} // namespace Rgemm_qd_scalar
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#pragma GCC optimize("fp-contract=off")
+namespace Rgemm_qd_avx2 {
+typedef __m256d V;
+constexpr int64_t L = 4;
+inline V vzero() { return _mm256_setzero_pd(); }
+inline V vload(double const *p) { return _mm256_loadu_pd(p); }
+inline V vbroadcast(double const *p) { return _mm256_broadcast_sd(p); }
+inline void vstore(double *p, V v) { _mm256_storeu_pd(p, v); }
+inline V vfms(V a, V b, V c) { return _mm256_fmsub_pd(a, b, c); }
+inline void vsplit(V a, V b, V &even, V &odd) {
+    even = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0xd8);
+    odd = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xd8);
+}
+inline void vmerge(V even, V odd, V &a, V &b) {
+    V e = _mm256_permute4x64_pd(even, 0xd8);
+    V o = _mm256_permute4x64_pd(odd, 0xd8);
+    a = _mm256_unpacklo_pd(e, o);
+    b = _mm256_unpackhi_pd(e, o);
+}
+#include "Rgemm_qd_lanes.hpp"
+} // namespace Rgemm_qd_avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")
+namespace Rgemm_qd_avx512 {
+typedef __m512d V;
+constexpr int64_t L = 8;
+inline V vzero() { return _mm512_setzero_pd(); }
+inline V vload(double const *p) { return _mm512_loadu_pd(p); }
+inline V vbroadcast(double const *p) { return _mm512_set1_pd(*p); }
+inline void vstore(double *p, V v) { _mm512_storeu_pd(p, v); }
+inline V vfms(V a, V b, V c) { return _mm512_fmsub_pd(a, b, c); }
+inline void vsplit(V a, V b, V &even, V &odd) {
+    even = _mm512_permutex2var_pd(a, _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14), b);
+    odd = _mm512_permutex2var_pd(a, _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15), b);
+}
+inline void vmerge(V even, V odd, V &a, V &b) {
+    a = _mm512_permutex2var_pd(even, _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11), odd);
+    b = _mm512_permutex2var_pd(even, _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15), odd);
+}
+#include "Rgemm_qd_lanes.hpp"
+} // namespace Rgemm_qd_avx512
+#pragma GCC pop_options
+#endif
+
+//
+//     A selected kernel for LIMBS-double arithmetic: ab := Ap * Bp on a full
+//     mr x nr tile, in the limb layout of Rgemm_kernel_dd/Rgemm_kernel_qd.
+//
+struct Rgemm_qd_kernel {
+    int64_t mr;
+    int64_t nr;
+    void (*run)(int64_t const kc, double const *ap, double const *bp, double *ab);
+};
+
+//
+//     The kernels of the widest instruction set the CPU supports, the default
+//     first; found once.  Every register tile has at most 64 elements (the
+//     buffer of Rgemm_kernel_limbs::run).
+//
+template <int64_t LIMBS> std::vector<Rgemm_qd_kernel> const &Rgemm_qd_kernels() {
+    static const std::vector<Rgemm_qd_kernel> kernels = []() {
+#if defined(__x86_64__) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            if (LIMBS == 2) {
+                return std::vector<Rgemm_qd_kernel>{{8, 8, &Rgemm_qd_avx512::Rgemm_kernel_dd<1, 8>}, {16, 4, &Rgemm_qd_avx512::Rgemm_kernel_dd<2, 4>}, {8, 4, &Rgemm_qd_avx512::Rgemm_kernel_dd<1, 4>}};
+            }
+            return std::vector<Rgemm_qd_kernel>{{8, 4, &Rgemm_qd_avx512::Rgemm_kernel_qd<1, 4>}, {16, 2, &Rgemm_qd_avx512::Rgemm_kernel_qd<2, 2>}, {8, 2, &Rgemm_qd_avx512::Rgemm_kernel_qd<1, 2>}};
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            if (LIMBS == 2) {
+                return std::vector<Rgemm_qd_kernel>{{4, 4, &Rgemm_qd_avx2::Rgemm_kernel_dd<1, 4>}, {8, 2, &Rgemm_qd_avx2::Rgemm_kernel_dd<2, 2>}, {4, 8, &Rgemm_qd_avx2::Rgemm_kernel_dd<1, 8>}};
+            }
+            return std::vector<Rgemm_qd_kernel>{{4, 2, &Rgemm_qd_avx2::Rgemm_kernel_qd<1, 2>}, {8, 1, &Rgemm_qd_avx2::Rgemm_kernel_qd<2, 1>}, {4, 4, &Rgemm_qd_avx2::Rgemm_kernel_qd<1, 4>}};
+        }
+#endif
+        if (LIMBS == 2) {
+            return std::vector<Rgemm_qd_kernel>{{4, 2, &Rgemm_qd_scalar::Rgemm_kernel_dd<4, 2>}, {2, 2, &Rgemm_qd_scalar::Rgemm_kernel_dd<2, 2>}, {2, 4, &Rgemm_qd_scalar::Rgemm_kernel_dd<2, 4>}};
+        }
+        return std::vector<Rgemm_qd_kernel>{{2, 2, &Rgemm_qd_scalar::Rgemm_kernel_qd<2, 2>}, {2, 1, &Rgemm_qd_scalar::Rgemm_kernel_qd<2, 1>}, {1, 2, &Rgemm_qd_scalar::Rgemm_kernel_qd<1, 2>}};
+    }();
+    return kernels;
+}
+
+//
+//     The "N" Rgemv kernel (Rgemv_kernel_n) of the widest instruction set the
+//     CPU supports for LIMBS-double arithmetic and NC columns; found once.
+//
+typedef int64_t (*Rgemv_qd_kernel)(int64_t const m, double const *tl, double const *a, int64_t const lda, double *y);
+
+template <int64_t LIMBS, int64_t NC> Rgemv_qd_kernel Rgemv_qd_kernel_n() {
+    static const Rgemv_qd_kernel kernel = []() -> Rgemv_qd_kernel {
+#if defined(__x86_64__) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return &Rgemm_qd_avx512::Rgemv_kernel_n<LIMBS, 2, NC>;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return &Rgemm_qd_avx2::Rgemv_kernel_n<LIMBS, 2, NC>;
+        }
+#endif
+        return &Rgemm_qd_scalar::Rgemv_kernel_n<LIMBS, 4, NC>;
+    }();
+    return kernel;
+}
+
+//
+//     The kernel in use: the register tile of the tuning file of REAL if the
+//     CPU has a kernel for it, else the default.  Rgemm_shapes changes it.
+//
+template <typename REAL, int64_t LIMBS> Rgemm_qd_kernel const *&Rgemm_qd_current() {
+    static Rgemm_qd_kernel const *kernel = []() {
+        std::vector<Rgemm_qd_kernel> const &kernels = Rgemm_qd_kernels<LIMBS>();
+        const Rgemm_tuning t = Rgemm_tuned<REAL>();
+        for (Rgemm_qd_kernel const &k : kernels) {
+            if ((k.mr == t.mr) && (k.nr == t.nr)) {
+                return &k;
+            }
+        }
+        return &kernels[0];
+    }();
+    return kernel;
+}
+
+//
+//     Limb t of x: x.x[t] for a libqd type, x itself (t = 0) for a hardware
+//     floating point type, and zero past the last limb, so that double or
+//     dd_real data can be packed for a wider kernel.
+//
+template <typename REAL> double Rgemm_limb(REAL const &x, int64_t const t) {
+    if constexpr (requires { x.x[0]; }) {
+        return (t < (int64_t)(sizeof(x.x) / sizeof(x.x[0]))) ? x.x[t] : 0.0;
+    } else {
+        return (t == 0) ? (double)x : 0.0;
+    }
+}
+
+//
+//     Pack op(A) and op(B) as in Rgemm_pack_a/Rgemm_pack_b, but split each
+//     element into its LIMBS doubles: every step holds limb 0 of the whole
+//     sliver, then limb 1, and so on.
+//
+template <typename REAL, int64_t LIMBS> void Rgemm_pack_a_limbs(int64_t const mc, int64_t const kc, REAL const *a, int64_t const rsa, int64_t const csa, int64_t const mr, double *ap) {
+    for (int64_t ir = 0; ir < mc; ir += mr) {
+        int64_t ib = std::min(mr, mc - ir);
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t i = 0; i < ib; i++) {
+                REAL const &x = a[(ir + i) * rsa + l * csa];
+                for (int64_t t = 0; t < LIMBS; t++) {
+                    ap[t * mr + i] = Rgemm_limb(x, t);
+                }
+            }
+            for (int64_t t = 0; t < LIMBS; t++) {
+                for (int64_t i = ib; i < mr; i++) {
+                    ap[t * mr + i] = 0.0;
+                }
+            }
+            ap += LIMBS * mr;
+        }
+    }
+}
+
+template <typename REAL, int64_t LIMBS> void Rgemm_pack_b_limbs(int64_t const kc, int64_t const nc, REAL const *b, int64_t const rsb, int64_t const csb, int64_t const nr, double *bp) {
+    for (int64_t jr = 0; jr < nc; jr += nr) {
+        int64_t jb = std::min(nr, nc - jr);
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t j = 0; j < jb; j++) {
+                REAL const &x = b[l * rsb + (jr + j) * csb];
+                for (int64_t t = 0; t < LIMBS; t++) {
+                    bp[t * nr + j] = Rgemm_limb(x, t);
+                }
+            }
+            for (int64_t t = 0; t < LIMBS; t++) {
+                for (int64_t j = jb; j < nr; j++) {
+                    bp[t * nr + j] = 0.0;
+                }
+            }
+            bp += LIMBS * nr;
+        }
+    }
+}
+
+//
+//     Rgemm_kernel for a libqd type with LIMBS doubles.
+//
+template <typename REAL, int64_t LIMBS> struct Rgemm_kernel_limbs {
+    typedef double packed_t;
+    static constexpr int64_t packed_size = LIMBS;
+    static int64_t mr() { return Rgemm_qd_current<REAL, LIMBS>()->mr; }
+    static int64_t nr() { return Rgemm_qd_current<REAL, LIMBS>()->nr; }
+    static void pack_a(int64_t const mc, int64_t const kc, REAL const *a, int64_t const rsa, int64_t const csa, int64_t const mr, double *ap) { Rgemm_pack_a_limbs<REAL, LIMBS>(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, REAL const *b, int64_t const rsb, int64_t const csb, int64_t const nr, double *bp) { Rgemm_pack_b_limbs<REAL, LIMBS>(kc, nc, b, rsb, csb, nr, bp); }
+    static void run(int64_t const kc, REAL const &alpha, double const *ap, double const *bp, REAL const &beta, REAL *c, int64_t const ldc, int64_t const mr, int64_t const nr) {
+        Rgemm_qd_kernel const &kernel = *Rgemm_qd_current<REAL, LIMBS>();
+        const int64_t tile = kernel.mr * kernel.nr;
+        double ab[LIMBS * 8 * 8];
+        kernel.run(kc, ap, bp, ab);
+        const Mscalar ca = Mscalar_of(alpha);
+        const Mscalar cb = Mscalar_of(beta);
+        for (int64_t j = 0; j < nr; j++) {
+            for (int64_t i = 0; i < mr; i++) {
+                REAL x;
+                for (int64_t t = 0; t < LIMBS; t++) {
+                    x.x[t] = ab[t * tile + i + j * kernel.mr];
+                }
+                Rgemm_store(ca, alpha, x, cb, beta, c[i + j * ldc]);
+            }
+        }
+    }
+};
+
+template <typename REAL, int64_t LIMBS> struct Rgemm_shapes_limbs {
+    static std::vector<std::pair<int64_t, int64_t>> list() {
+        std::vector<std::pair<int64_t, int64_t>> shapes;
+        for (Rgemm_qd_kernel const &k : Rgemm_qd_kernels<LIMBS>()) {
+            shapes.push_back({k.mr, k.nr});
+        }
+        return shapes;
+    }
+    static bool use(int64_t const mr, int64_t const nr) {
+        for (Rgemm_qd_kernel const &k : Rgemm_qd_kernels<LIMBS>()) {
+            if ((k.mr == mr) && (k.nr == nr)) {
+                Rgemm_qd_current<REAL, LIMBS>() = &k;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+//
+//     Packing of narrower data (double, or dd_real for qd_real) for the
+//     kernel of a libqd type; the missing limbs are zero.
+//
+template <typename TIN, int64_t LIMBS> struct Rgemm_widen_limbs {
+    typedef double packed_t;
+    static void pack_a(int64_t const mc, int64_t const kc, TIN const *a, int64_t const rsa, int64_t const csa, int64_t const mr, double *ap) { Rgemm_pack_a_limbs<TIN, LIMBS>(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, TIN const *b, int64_t const rsb, int64_t const csb, int64_t const nr, double *bp) { Rgemm_pack_b_limbs<TIN, LIMBS>(kc, nc, b, rsb, csb, nr, bp); }
+};
+
+} // namespace mpblas
+
+#endif
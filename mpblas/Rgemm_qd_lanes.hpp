@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Double-double and quad-double multiply-add on L lanes at once, and the
+Rgemm micro-kernels and the "N" Rgemv kernel built from them.  The limbs are kept in separate
+registers (structure of arrays), so each error-free transformation is a
+handful of vector instructions working on L independent C entries.
+
+This file has no include guard: Rgemm_qd.hpp includes it once per
+instruction set, inside a namespace and a target pragma that provide
+  V, L                           the lane type and the number of lanes,
+  vzero, vload, vbroadcast,
+  vstore, vfms                   vfms(a, b, c) = a * b - c rounded once,
+  vsplit, vmerge                 vsplit(a, b, even, odd) takes the even and
+                                 the odd doubles of the 2L at a and b apart,
+                                 vmerge(even, odd, a, b) puts them back.
+V must support +, - and * elementwise (double and the GCC vector types do).
+The formulas are those of libqd (Hida, Li and Bailey).
+*/
+
+inline V two_sum(V a, V b, V &err) {
+    V s = a + b;
+    V bb = s - a;
+    err = (a - (s - bb)) + (b - bb);
+    return s;
+}
+
+inline V quick_two_sum(V a, V b, V &err) {
+    V s = a + b;
+    err = b - (s - a);
+    return s;
+}
+
+inline V two_prod(V a, V b, V &err) {
+    V p = a * b;
+    err = vfms(a, b, p);
+    return p;
+}
+
+//
+//     (c0, c1) := (c0, c1) + (a0, a1) * (b0, b1): dd_real's multiply followed
+//     by its IEEE-style add.
+//
+inline void dd_madd(V a0, V a1, V b0, V b1, V &c0, V &c1) {
+    V p0, p1, s1, s2, t1, t2;
+    p0 = two_prod(a0, b0, p1);
+    p1 += (a0 * b1 + a1 * b0);
+    p0 = quick_two_sum(p0, p1, p1);
+    s1 = two_sum(c0, p0, s2);
+    t1 = two_sum(c1, p1, t2);
+    s2 += t1;
+    s1 = quick_two_sum(s1, s2, s2);
+    s2 += t2;
+    c0 = quick_two_sum(s1, s2, c1);
+}
+
+inline void three_sum(V &a, V &b, V &c) {
+    V t1, t2, t3;
+    t1 = two_sum(a, b, t2);
+    a = two_sum(c, t1, t3);
+    b = two_sum(t2, t3, c);
+}
+
+inline void three_sum2(V &a, V &b, V &c) {
+    V t1, t2, t3;
+    t1 = two_sum(a, b, t2);
+    a = two_sum(c, t1, t3);
+    b = t2 + t3;
+}
+
+//
+//     libqd's renormalization without its tests for zero components, which
+//     cannot be taken per lane.  A zero component is carried along instead of
+//     being squeezed out, so no information is lost.
+//
+inline void renorm(V &c0, V &c1, V &c2, V &c3, V &c4) {
+    V s0, s1, s2, s3;
+    s0 = quick_two_sum(c3, c4, c4);
+    s0 = quick_two_sum(c2, s0, c3);
+    s0 = quick_two_sum(c1, s0, c2);
+    c0 = quick_two_sum(c0, s0, c1);
+    s1 = quick_two_sum(c1, c2, s2);
+    s2 = quick_two_sum(s2, c3, s3);
+    s3 += c4;
+    c1 = s1;
+    c2 = s2;
+    c3 = s3;
+}
+
+//
+//     c := c + a * b in quad-double: qd_real's (sloppy) multiply followed by
+//     its (sloppy) add.
+//
+inline void qd_madd(V const *a, V const *b, V *c) {
+    V p0, p1, p2, p3, p4, p5;
+    V q0, q1, q2, q3, q4, q5;
+    V t0, t1, t2, t3;
+    V s0, s1, s2;
+    p0 = two_prod(a[0], b[0], q0);
+    p1 = two_prod(a[0], b[1], q1);
+    p2 = two_prod(a[1], b[0], q2);
+    p3 = two_prod(a[0], b[2], q3);
+    p4 = two_prod(a[1], b[1], q4);
+    p5 = two_prod(a[2], b[0], q5);
+    three_sum(p1, p2, q0);
+    three_sum(p2, q1, q2);
+    three_sum(p3, p4, p5);
+    s0 = two_sum(p2, p3, t0);
+    s1 = two_sum(q1, p4, t1);
+    s2 = q2 + p5;
+    s1 = two_sum(s1, t0, t0);
+    s2 += (t0 + t1);
+    s1 += a[0] * b[3] + a[1] * b[2] + a[2] * b[1] + a[3] * b[0] + q0 + q3 + q4 + q5;
+    renorm(p0, p1, s0, s1, s2);
+    //
+    //     c + (p0, p1, s0, s1).
+    //
+    V u0, u1, u2, u3;
+    t0 = two_sum(c[0], p0, u0);
+    t1 = two_sum(c[1], p1, u1);
+    t2 = two_sum(c[2], s0, u2);
+    t3 = two_sum(c[3], s1, u3);
+    t1 = two_sum(t1, u0, u0);
+    three_sum(t2, u0, u1);
+    three_sum2(t3, u0, u2);
+    u0 = u0 + u1 + u3;
+    renorm(t0, t1, t2, t3, u0);
+    c[0] = t0;
+    c[1] = t1;
+    c[2] = t2;
+    c[3] = t3;
+}
+
+//
+//     ab := Ap * Bp for an MR x NR tile (MR = MV * L), limb by limb:
+//     ab[t * MR * NR + i + j * MR] is limb t of element (i, j).  Each step of
+//     Ap holds LIMBS runs of MR doubles, each step of Bp LIMBS runs of NR.
+//
+template <int64_t MV, int64_t NR> void Rgemm_kernel_dd(int64_t const kc, double const *ap, double const *bp, double *ab) {
+    constexpr int64_t MR = MV * L;
+    V c0[MV * NR];
+    V c1[MV * NR];
+    for (int64_t p = 0; p < MV * NR; p++) {
+        c0[p] = vzero();
+        c1[p] = vzero();
+    }
+    for (int64_t l = 0; l < kc; l++) {
+        V a0[MV];
+        V a1[MV];
+        for (int64_t v = 0; v < MV; v++) {
+            a0[v] = vload(&ap[v * L]);
+            a1[v] = vload(&ap[MR + v * L]);
+        }
+        for (int64_t j = 0; j < NR; j++) {
+            V b0 = vbroadcast(&bp[j]);
+            V b1 = vbroadcast(&bp[NR + j]);
+            for (int64_t v = 0; v < MV; v++) {
+                dd_madd(a0[v], a1[v], b0, b1, c0[v + j * MV], c1[v + j * MV]);
+            }
+        }
+        ap += 2 * MR;
+        bp += 2 * NR;
+    }
+    for (int64_t j = 0; j < NR; j++) {
+        for (int64_t v = 0; v < MV; v++) {
+            vstore(&ab[v * L + j * MR], c0[v + j * MV]);
+            vstore(&ab[MR * NR + v * L + j * MR], c1[v + j * MV]);
+        }
+    }
+}
+
+template <int64_t MV, int64_t NR> void Rgemm_kernel_qd(int64_t const kc, double const *ap, double const *bp, double *ab) {
+    constexpr int64_t MR = MV * L;
+    V c[MV * NR][4];
+    for (int64_t p = 0; p < MV * NR; p++) {
+        for (int64_t t = 0; t < 4; t++) {
+            c[p][t] = vzero();
+        }
+    }
+    for (int64_t l = 0; l < kc; l++) {
+        V a[MV][4];
+        for (int64_t v = 0; v < MV; v++) {
+            for (int64_t t = 0; t < 4; t++) {
+                a[v][t] = vload(&ap[t * MR + v * L]);
+            }
+        }
+        for (int64_t j = 0; j < NR; j++) {
+            V b[4];
+            for (int64_t t = 0; t < 4; t++) {
+                b[t] = vbroadcast(&bp[t * NR + j]);
+            }
+            for (int64_t v = 0; v < MV; v++) {
+                qd_madd(a[v], b, c[v + j * MV]);
+            }
+        }
+        ap += 4 * MR;
+        bp += 4 * NR;
+    }
+    for (int64_t j = 0; j < NR; j++) {
+        for (int64_t v = 0; v < MV; v++) {
+            for (int64_t t = 0; t < 4; t++) {
+                vstore(&ab[t * MR * NR + v * L + j * MR], c[v + j * MV][t]);
+            }
+        }
+    }
+}
+
+//
+//     The L elements of LIMBS doubles each at p as LIMBS vectors of limbs,
+//     and back.
+//
+template <int64_t LIMBS> inline void vload_limbs(double const *p, V *v) {
+    if constexpr (LIMBS == 2) {
+        vsplit(vload(p), vload(p + L), v[0], v[1]);
+    } else {
+        alignas(64) double w[LIMBS][L];
+        for (int64_t i = 0; i < L; i++) {
+            for (int64_t t = 0; t < LIMBS; t++) {
+                w[t][i] = p[i * LIMBS + t];
+            }
+        }
+        for (int64_t t = 0; t < LIMBS; t++) {
+            v[t] = vload(w[t]);
+        }
+    }
+}
+
+template <int64_t LIMBS> inline void vstore_limbs(double *p, V const *v) {
+    if constexpr (LIMBS == 2) {
+        V a, b;
+        vmerge(v[0], v[1], a, b);
+        vstore(p, a);
+        vstore(p + L, b);
+    } else {
+        alignas(64) double w[LIMBS][L];
+        for (int64_t t = 0; t < LIMBS; t++) {
+            vstore(w[t], v[t]);
+        }
+        for (int64_t i = 0; i < L; i++) {
+            for (int64_t t = 0; t < LIMBS; t++) {
+                p[i * LIMBS + t] = w[t][i];
+            }
+        }
+    }
+}
+
+//
+//     y := y + t(0)*A(:,0) + ... + t(NC-1)*A(:,NC-1) on the first rows of y,
+//     in groups of MV * L; returns the number of rows done.  y and A are
+//     arrays of elements of LIMBS doubles, lda counts elements and
+//     tl[c * LIMBS + t] is limb t of t(c).  The MV * L rows of a group are
+//     independent, so their chains of multiply-adds overlap.
+//
+template <int64_t LIMBS, int64_t MV, int64_t NC> int64_t Rgemv_kernel_n(int64_t const m, double const *tl, double const *a, int64_t const lda, double *y) {
+    constexpr int64_t MR = MV * L;
+    V t[NC][LIMBS];
+    for (int64_t c = 0; c < NC; c++) {
+        for (int64_t k = 0; k < LIMBS; k++) {
+            t[c][k] = vbroadcast(&tl[c * LIMBS + k]);
+        }
+    }
+    int64_t i = 0;
+    for (i = 0; i + MR <= m; i += MR) {
+        V yv[MV][LIMBS];
+        for (int64_t v = 0; v < MV; v++) {
+            vload_limbs<LIMBS>(&y[(i + v * L) * LIMBS], yv[v]);
+        }
+        for (int64_t c = 0; c < NC; c++) {
+            for (int64_t v = 0; v < MV; v++) {
+                V av[LIMBS];
+                vload_limbs<LIMBS>(&a[(c * lda + i + v * L) * LIMBS], av);
+                if constexpr (LIMBS == 2) {
+                    dd_madd(t[c][0], t[c][1], av[0], av[1], yv[v][0], yv[v][1]);
+                } else {
+                    qd_madd(t[c], av, yv[v]);
+                }
+            }
+        }
+        for (int64_t v = 0; v < MV; v++) {
+            vstore_limbs<LIMBS>(&y[(i + v * L) * LIMBS], yv[v]);
+        }
+    }
+    return i;
+}
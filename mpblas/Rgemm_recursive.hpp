@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Cache-oblivious Rgemm: C := alpha*op(A)*op(B) + beta*C by halving the
+largest of m, n and k until all three are at most a leaf size, where the
+blocked engine's micro-kernel runs on packed copies of the leaf blocks.
+There are no blocking parameters to tune: whatever the cache sizes, some
+level of the recursion fits each of them.  The leaf size only assumes an L2
+cache of at least 256 KiB; leaves that small in L1 would make the packing
+and the loads and stores of C in the micro-kernel a large part of the work.
+With morton set, op(A), op(B) and C are first copied into square tiles of
+leaf size stored in a generalized Z (Morton) order, so that every level of
+the recursion works on contiguous memory; the copies cost O(mk + kn + mn).
+Parallel runs cut C into tiles of whole leaves (Mparallel_tiles), each
+recursing on its own; the k halving depends on k only, so the result is
+bitwise identical for any number of threads.  It differs from the blocked
+engine's, whose k blocks are KC long.
+*/
+
+#ifndef ___MPBLAS_RGEMM_RECURSIVE_H___
+#define ___MPBLAS_RGEMM_RECURSIVE_H___
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     Leaf size: three leaf blocks of REAL fit in 256 KiB.  It is a multiple
+//     of the register tile in both directions.
+//
+template <typename REAL> int64_t Rgemm_recursive_leaf() {
+    const int64_t align = std::lcm(Rgemm_kernel<REAL>::mr(), Rgemm_kernel<REAL>::nr());
+    const int64_t side = (int64_t)std::sqrt(262144.0 / (3.0 * (double)sizeof(REAL)));
+    return std::max(align, side / align * align);
+}
+
+//
+//     Where to halve len: at a multiple of align if that leaves both halves
+//     nonempty, else in the middle.
+//
+inline int64_t Rgemm_recursive_half(int64_t const len, int64_t const align) {
+    const int64_t half = (len / 2 + align - 1) / align * align;
+    return (half < len) ? half : len / 2;
+}
+
+//
+//     C := C + alpha*op(A)*op(B) on the operands in place.
+//
+template <typename REAL> void Rgemm_recursive_update(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL *c, int64_t const ldc, int64_t const leaf) {
+    if ((m == 0) || (n == 0) || (k == 0)) {
+        return;
+    }
+    if (std::max(std::max(m, n), k) <= leaf) {
+        Rgemm_update(nota, notb, m, n, k, alpha, a, lda, b, ldb, REAL(1.0), c, ldc);
+        return;
+    }
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csa = nota ? lda : 1;
+    const int64_t rsb = notb ? 1 : ldb;
+    const int64_t csb = notb ? ldb : 1;
+    if ((m >= n) && (m >= k)) {
+        const int64_t h = Rgemm_recursive_half(m, Rgemm_kernel<REAL>::mr());
+        Rgemm_recursive_update(nota, notb, h, n, k, alpha, a, lda, b, ldb, c, ldc, leaf);
+        Rgemm_recursive_update(nota, notb, m - h, n, k, alpha, &a[h * rsa], lda, b, ldb, &c[h], ldc, leaf);
+    } else if (n >= k) {
+        const int64_t h = Rgemm_recursive_half(n, Rgemm_kernel<REAL>::nr());
+        Rgemm_recursive_update(nota, notb, m, h, k, alpha, a, lda, b, ldb, c, ldc, leaf);
+        Rgemm_recursive_update(nota, notb, m, n - h, k, alpha, a, lda, &b[h * csb], ldb, &c[h * ldc], ldc, leaf);
+    } else {
+        const int64_t h = Rgemm_recursive_half(k, 1);
+        Rgemm_recursive_update(nota, notb, m, n, h, alpha, a, lda, b, ldb, c, ldc, leaf);
+        Rgemm_recursive_update(nota, notb, m, n, k - h, alpha, &a[h * csa], lda, &b[h * rsb], ldb, c, ldc, leaf);
+    }
+}
+
+//
+//     Number the tiles [r0, r1) x [c0, c1) of a grid with tr rows of tiles
+//     from next on, halving the longer side (the rows on a tie) and numbering
+//     the first half first.  On a 2^p x 2^p grid this is the Morton order.
+//
+inline void Rgemm_morton_order(int64_t const r0, int64_t const r1, int64_t const c0, int64_t const c1, int64_t const tr, int64_t &next, int64_t *pos) {
+    if ((r1 - r0 == 1) && (c1 - c0 == 1)) {
+        pos[r0 + c0 * tr] = next++;
+    } else if (r1 - r0 >= c1 - c0) {
+        Rgemm_morton_order(r0, (r0 + r1) / 2, c0, c1, tr, next, pos);
+        Rgemm_morton_order((r0 + r1) / 2, r1, c0, c1, tr, next, pos);
+    } else {
+        Rgemm_morton_order(r0, r1, c0, (c0 + c1) / 2, tr, next, pos);
+        Rgemm_morton_order(r0, r1, (c0 + c1) / 2, c1, tr, next, pos);
+    }
+}
+
+//
+//     An m x n matrix as a tr x tc grid of s x s column major tiles, tile
+//     (ti, tj) at p + pos[ti + tj * tr] * s * s.  Edge tiles are partly used.
+//
+template <typename REAL> struct Rgemm_morton_matrix {
+    int64_t m;
+    int64_t n;
+    int64_t s;
+    int64_t tr;
+    int64_t tc;
+    REAL *p;
+    std::vector<int64_t> pos;
+
+    Rgemm_morton_matrix(int64_t const m_, int64_t const n_, int64_t const s_, REAL *p_) : m(m_), n(n_), s(s_), tr((m_ + s_ - 1) / s_), tc((n_ + s_ - 1) / s_), p(p_), pos(tr * tc) {
+        int64_t next = 0;
+        Rgemm_morton_order(0, tr, 0, tc, tr, next, pos.data());
+    }
+    REAL *tile(int64_t const ti, int64_t const tj) const { return p + pos[ti + tj * tr] * s * s; }
+
+    //
+    //     Copy in (or, with out set, back out) the matrix x(i, j) =
+    //     x[i * rs + j * cs].
+    //
+    void copy(REAL *x, int64_t const rs, int64_t const cs, bool const out) const {
+        for (int64_t tj = 0; tj < tc; tj++) {
+            for (int64_t ti = 0; ti < tr; ti++) {
+                REAL *t = tile(ti, tj);
+                const int64_t mb = std::min(s, m - ti * s);
+                const int64_t nb = std::min(s, n - tj * s);
+                for (int64_t j = 0; j < nb; j++) {
+                    REAL *xj = &x[(ti * s) * rs + (tj * s + j) * cs];
+                    for (int64_t i = 0; i < mb; i++) {
+                        if (out) {
+                            xj[i * rs] = t[i + j * s];
+                        } else {
+                            t[i + j * s] = xj[i * rs];
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+//
+//     C := C + alpha*A*B on the tiles [i0, i1) x [j0, j1) of C and
+//     [l0, l1) of the inner dimension, halving the longest range.
+//
+template <typename REAL> void Rgemm_morton_rec(int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1, int64_t const l0, int64_t const l1, REAL const &alpha, Rgemm_morton_matrix<REAL> const &a, Rgemm_morton_matrix<REAL> const &b, Rgemm_morton_matrix<REAL> const &c) {
+    const int64_t s = c.s;
+    if ((i1 - i0 == 1) && (j1 - j0 == 1) && (l1 - l0 == 1)) {
+        const int64_t mb = std::min(s, c.m - i0 * s);
+        const int64_t nb = std::min(s, c.n - j0 * s);
+        const int64_t kb = std::min(s, a.n - l0 * s);
+        Rgemm_update(true, true, mb, nb, kb, alpha, a.tile(i0, l0), s, b.tile(l0, j0), s, REAL(1.0), c.tile(i0, j0), s);
+    } else if ((i1 - i0 >= j1 - j0) && (i1 - i0 >= l1 - l0)) {
+        Rgemm_morton_rec(i0, (i0 + i1) / 2, j0, j1, l0, l1, alpha, a, b, c);
+        Rgemm_morton_rec((i0 + i1) / 2, i1, j0, j1, l0, l1, alpha, a, b, c);
+    } else if (j1 - j0 >= l1 - l0) {
+        Rgemm_morton_rec(i0, i1, j0, (j0 + j1) / 2, l0, l1, alpha, a, b, c);
+        Rgemm_morton_rec(i0, i1, (j0 + j1) / 2, j1, l0, l1, alpha, a, b, c);
+    } else {
+        Rgemm_morton_rec(i0, i1, j0, j1, l0, (l0 + l1) / 2, alpha, a, b, c);
+        Rgemm_morton_rec(i0, i1, j0, j1, (l0 + l1) / 2, l1, alpha, a, b, c);
+    }
+}
+
+//
+//     C := C + alpha*op(A)*op(B) through Morton-ordered copies of the
+//     operands in a per-thread buffer.
+//
+template <typename REAL> void Rgemm_morton_update(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL *c, int64_t const ldc, int64_t const leaf) {
+    if ((m == 0) || (n == 0) || (k == 0)) {
+        return;
+    }
+    const int64_t tm = (m + leaf - 1) / leaf;
+    const int64_t tn = (n + leaf - 1) / leaf;
+    const int64_t tk = (k + leaf - 1) / leaf;
+    thread_local Mbuffer<REAL> buffer;
+    REAL *at = buffer.reserve((tm * tk + tk * tn + tm * tn) * leaf * leaf);
+    REAL *bt = at + tm * tk * leaf * leaf;
+    REAL *ct = bt + tk * tn * leaf * leaf;
+    Rgemm_morton_matrix<REAL> am(m, k, leaf, at);
+    Rgemm_morton_matrix<REAL> bm(k, n, leaf, bt);
+    Rgemm_morton_matrix<REAL> cm(m, n, leaf, ct);
+    am.copy(a, nota ? 1 : lda, nota ? lda : 1, false);
+    bm.copy(b, notb ? 1 : ldb, notb ? ldb : 1, false);
+    cm.copy(c, 1, ldc, false);
+    Rgemm_morton_rec(0, tm, 0, tn, 0, tk, alpha, am, bm, cm);
+    cm.copy(c, 1, ldc, true);
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C by the recursion, in place or, with
+//     morton set, on Morton-ordered copies.  The arguments are those of
+//     Rgemm after validation; alpha is nonzero.
+//
+template <typename REAL> void Rgemm_recursive(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc, bool const morton) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    const int64_t leaf = Rgemm_recursive_leaf<REAL>();
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csb = notb ? ldb : 1;
+    auto tile = [&](int64_t const i0, int64_t const i1, int64_t const j0, int64_t const j1) {
+        Rgemm_scale(i1 - i0, j1 - j0, beta, zero, one, &c[i0 + j0 * ldc], ldc);
+        if (morton) {
+            Rgemm_morton_update(nota, notb, i1 - i0, j1 - j0, k, alpha, &a[i0 * rsa], lda, &b[j0 * csb], ldb, &c[i0 + j0 * ldc], ldc, leaf);
+        } else {
+            Rgemm_recursive_update(nota, notb, i1 - i0, j1 - j0, k, alpha, &a[i0 * rsa], lda, &b[j0 * csb], ldb, &c[i0 + j0 * ldc], ldc, leaf);
+        }
+    };
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), m * n * std::max(k, (int64_t)1) / Rgemm_blocking<REAL>::work_per_thread);
+    if (nthreads <= 1) {
+        tile(0, m, 0, n);
+        return;
+    }
+    Mparallel_tiles(m, n, leaf, leaf, nthreads, tile, Rgemm_tasks_per_thread<REAL>());
+}
+} // namespace mpblas
+
+#endif
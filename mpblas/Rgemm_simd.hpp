@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Hand-vectorized Rgemm micro-kernels for float and double (SSE2, AVX2+FMA,
+AVX-512F) and the _Float16 kernel, which packs through F16C into float panels
+and accumulates in float.  The kernel is chosen once at run time from the CPU
+features, so a single binary runs on every x86-64 machine.  Each kernel
+updates a full MR x NR tile of C; partial tiles go through a local buffer so
+that every element of C sees exactly the same operations wherever it lies.
+*/
+
+#ifndef ___MPBLAS_RGEMM_SIMD_H___
+#define ___MPBLAS_RGEMM_SIMD_H___
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+#include <cstring>
+#include <immintrin.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mpblas {
+
+//
+//     A selected kernel: C(0:mr-1, 0:nr-1) := alpha * Ap * Bp + beta * C on a
+//     full tile; C is not read when beta is zero.
+//
+template <typename T> struct Rgemm_simd_kernel {
+    int64_t mr;
+    int64_t nr;
+    void (*run)(int64_t const kc, T const alpha, T const *ap, T const *bp, T const beta, T *c, int64_t const ldc);
+};
+
+//
+//     SSE2 (always available on x86-64).  In these traits and those below,
+//     stream is a non-temporal store; its address must be aligned to the
+//     size of V.
+//
+template <typename T> struct Rgemm_sse2;
+template <> struct Rgemm_sse2<double> {
+    typedef __m128d V;
+    static constexpr int64_t L = 2;
+    static inline V zero() { return _mm_setzero_pd(); }
+    static inline V load(double const *p) { return _mm_loadu_pd(p); }
+    static inline V broadcast(double const *p) { return _mm_load1_pd(p); }
+    static inline V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static inline V fma(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static inline void store(double *p, V v) { _mm_storeu_pd(p, v); }
+    static inline void stream(double *p, V v) { _mm_stream_pd(p, v); }
+};
+template <> struct Rgemm_sse2<float> {
+    typedef __m128 V;
+    static constexpr int64_t L = 4;
+    static inline V zero() { return _mm_setzero_ps(); }
+    static inline V load(float const *p) { return _mm_loadu_ps(p); }
+    static inline V broadcast(float const *p) { return _mm_load1_ps(p); }
+    static inline V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static inline V fma(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static inline void store(float *p, V v) { _mm_storeu_ps(p, v); }
+    static inline void stream(float *p, V v) { _mm_stream_ps(p, v); }
+};
+
+template <typename T, int64_t MV, int64_t NR> void Rgemm_kernel_sse2(int64_t const kc, T const alpha, T const *ap, T const *bp, T const beta, T *c, int64_t const ldc) {
+    typedef Rgemm_sse2<T> S;
+    typename S::V ab[MV * NR];
+    for (int64_t p = 0; p < MV * NR; p++) {
+        ab[p] = S::zero();
+    }
+    for (int64_t l = 0; l < kc; l++) {
+        typename S::V av[MV];
+        for (int64_t v = 0; v < MV; v++) {
+            av[v] = S::load(&ap[v * S::L]);
+        }
+        for (int64_t j = 0; j < NR; j++) {
+            typename S::V bj = S::broadcast(&bp[j]);
+            for (int64_t v = 0; v < MV; v++) {
+                ab[v + j * MV] = S::fma(av[v], bj, ab[v + j * MV]);
+            }
+        }
+        ap += MV * S::L;
+        bp += NR;
+    }
+    typename S::V va = S::broadcast(&alpha);
+    if (beta == T(0)) {
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::mul(va, ab[v + j * MV]));
+            }
+        }
+    } else if (beta == T(1)) {
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::fma(va, ab[v + j * MV], S::load(&c[v * S::L + j * ldc])));
+            }
+        }
+    } else {
+        typename S::V vb = S::broadcast(&beta);
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::fma(va, ab[v + j * MV], S::mul(vb, S::load(&c[v * S::L + j * ldc]))));
+            }
+        }
+    }
+}
+
+//
+//     AVX2 with FMA.
+//
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+template <typename T> struct Rgemm_avx2;
+template <> struct Rgemm_avx2<double> {
+    typedef __m256d V;
+    static constexpr int64_t L = 4;
+    static inline V zero() { return _mm256_setzero_pd(); }
+    static inline V load(double const *p) { return _mm256_loadu_pd(p); }
+    static inline V broadcast(double const *p) { return _mm256_broadcast_sd(p); }
+    static inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static inline V fma(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+    static inline void store(double *p, V v) { _mm256_storeu_pd(p, v); }
+    static inline void stream(double *p, V v) { _mm256_stream_pd(p, v); }
+};
+template <> struct Rgemm_avx2<float> {
+    typedef __m256 V;
+    static constexpr int64_t L = 8;
+    static inline V zero() { return _mm256_setzero_ps(); }
+    static inline V load(float const *p) { return _mm256_loadu_ps(p); }
+    static inline V broadcast(float const *p) { return _mm256_broadcast_ss(p); }
+    static inline V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static inline V fma(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static inline void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+    static inline void stream(float *p, V v) { _mm256_stream_ps(p, v); }
+};
+
+template <typename T, int64_t MV, int64_t NR> void Rgemm_kernel_avx2(int64_t const kc, T const alpha, T const *ap, T const *bp, T const beta, T *c, int64_t const ldc) {
+    typedef Rgemm_avx2<T> S;
+    typename S::V ab[MV * NR];
+    for (int64_t p = 0; p < MV * NR; p++) {
+        ab[p] = S::zero();
+    }
+    for (int64_t l = 0; l < kc; l++) {
+        typename S::V av[MV];
+        for (int64_t v = 0; v < MV; v++) {
+            av[v] = S::load(&ap[v * S::L]);
+        }
+        for (int64_t j = 0; j < NR; j++) {
+            typename S::V bj = S::broadcast(&bp[j]);
+            for (int64_t v = 0; v < MV; v++) {
+                ab[v + j * MV] = S::fma(av[v], bj, ab[v + j * MV]);
+            }
+        }
+        ap += MV * S::L;
+        bp += NR;
+    }
+    typename S::V va = S::broadcast(&alpha);
+    if (beta == T(0)) {
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::mul(va, ab[v + j * MV]));
+            }
+        }
+    } else if (beta == T(1)) {
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::fma(va, ab[v + j * MV], S::load(&c[v * S::L + j * ldc])));
+            }
+        }
+    } else {
+        typename S::V vb = S::broadcast(&beta);
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::fma(va, ab[v + j * MV], S::mul(vb, S::load(&c[v * S::L + j * ldc]))));
+            }
+        }
+    }
+}
+#pragma GCC pop_options
+
+//
+//     AVX-512F.
+//
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+template <typename T> struct Rgemm_avx512;
+template <> struct Rgemm_avx512<double> {
+    typedef __m512d V;
+    static constexpr int64_t L = 8;
+    static inline V zero() { return _mm512_setzero_pd(); }
+    static inline V load(double const *p) { return _mm512_loadu_pd(p); }
+    static inline V broadcast(double const *p) { return _mm512_set1_pd(*p); }
+    static inline V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static inline V fma(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+    static inline void store(double *p, V v) { _mm512_storeu_pd(p, v); }
+    static inline void stream(double *p, V v) { _mm512_stream_pd(p, v); }
+};
+template <> struct Rgemm_avx512<float> {
+    typedef __m512 V;
+    static constexpr int64_t L = 16;
+    static inline V zero() { return _mm512_setzero_ps(); }
+    static inline V load(float const *p) { return _mm512_loadu_ps(p); }
+    static inline V broadcast(float const *p) { return _mm512_set1_ps(*p); }
+    static inline V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static inline V fma(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+    static inline void store(float *p, V v) { _mm512_storeu_ps(p, v); }
+    static inline void stream(float *p, V v) { _mm512_stream_ps(p, v); }
+};
+
+template <typename T, int64_t MV, int64_t NR> void Rgemm_kernel_avx512(int64_t const kc, T const alpha, T const *ap, T const *bp, T const beta, T *c, int64_t const ldc) {
+    typedef Rgemm_avx512<T> S;
+    typename S::V ab[MV * NR];
+    for (int64_t p = 0; p < MV * NR; p++) {
+        ab[p] = S::zero();
+    }
+    for (int64_t l = 0; l < kc; l++) {
+        typename S::V av[MV];
+        for (int64_t v = 0; v < MV; v++) {
+            av[v] = S::load(&ap[v * S::L]);
+        }
+        for (int64_t j = 0; j < NR; j++) {
+            typename S::V bj = S::broadcast(&bp[j]);
+            for (int64_t v = 0; v < MV; v++) {
+                ab[v + j * MV] = S::fma(av[v], bj, ab[v + j * MV]);
+            }
+        }
+        ap += MV * S::L;
+        bp += NR;
+    }
+    typename S::V va = S::broadcast(&alpha);
+    if (beta == T(0)) {
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::mul(va, ab[v + j * MV]));
+            }
+        }
+    } else if (beta == T(1)) {
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::fma(va, ab[v + j * MV], S::load(&c[v * S::L + j * ldc])));
+            }
+        }
+    } else {
+        typename S::V vb = S::broadcast(&beta);
+        for (int64_t j = 0; j < NR; j++) {
+            for (int64_t v = 0; v < MV; v++) {
+                S::store(&c[v * S::L + j * ldc], S::fma(va, ab[v + j * MV], S::mul(vb, S::load(&c[v * S::L + j * ldc]))));
+            }
+        }
+    }
+}
+#pragma GCC pop_options
+
+//
+//     The kernels of the widest instruction set the CPU supports, the default
+//     first; found once per type.  Every register tile fits in the 32 x 12
+//     buffer of Rgemm_simd_run.
+//
+template <typename T> std::vector<Rgemm_simd_kernel<T>> const &Rgemm_simd_kernels() {
+    static const std::vector<Rgemm_simd_kernel<T>> kernels = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            constexpr int64_t L = Rgemm_avx512<T>::L;
+            return std::vector<Rgemm_simd_kernel<T>>{{2 * L, 12, &Rgemm_kernel_avx512<T, 2, 12>}, {3 * L, 8, &Rgemm_kernel_avx512<T, 3, 8>}, {4 * L, 6, &Rgemm_kernel_avx512<T, 4, 6>}, {2 * L, 8, &Rgemm_kernel_avx512<T, 2, 8>}};
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            constexpr int64_t L = Rgemm_avx2<T>::L;
+            return std::vector<Rgemm_simd_kernel<T>>{{2 * L, 6, &Rgemm_kernel_avx2<T, 2, 6>}, {3 * L, 4, &Rgemm_kernel_avx2<T, 3, 4>}, {2 * L, 4, &Rgemm_kernel_avx2<T, 2, 4>}};
+        }
+        constexpr int64_t L = Rgemm_sse2<T>::L;
+        return std::vector<Rgemm_simd_kernel<T>>{{2 * L, 4, &Rgemm_kernel_sse2<T, 2, 4>}, {4 * L, 2, &Rgemm_kernel_sse2<T, 4, 2>}, {2 * L, 6, &Rgemm_kernel_sse2<T, 2, 6>}};
+    }();
+    return kernels;
+}
+
+//
+//     The kernel in use: the register tile of the tuning file if the CPU has
+//     a kernel for it, else the default.  Rgemm_shapes<T>::use changes it.
+//
+template <typename T> Rgemm_simd_kernel<T> const *&Rgemm_simd_current() {
+    static Rgemm_simd_kernel<T> const *kernel = []() {
+        std::vector<Rgemm_simd_kernel<T>> const &kernels = Rgemm_simd_kernels<T>();
+        const Rgemm_tuning t = Rgemm_tuned<T>();
+        for (Rgemm_simd_kernel<T> const &k : kernels) {
+            if ((k.mr == t.mr) && (k.nr == t.nr)) {
+                return &k;
+            }
+        }
+        return &kernels[0];
+    }();
+    return kernel;
+}
+
+template <typename T> Rgemm_simd_kernel<T> const &Rgemm_simd_select() { return *Rgemm_simd_current<T>(); }
+
+template <typename T> struct Rgemm_simd_shapes {
+    static std::vector<std::pair<int64_t, int64_t>> list() {
+        std::vector<std::pair<int64_t, int64_t>> shapes;
+        for (Rgemm_simd_kernel<T> const &k : Rgemm_simd_kernels<T>()) {
+            shapes.push_back({k.mr, k.nr});
+        }
+        return shapes;
+    }
+    static bool use(int64_t const mr, int64_t const nr) {
+        for (Rgemm_simd_kernel<T> const &k : Rgemm_simd_kernels<T>()) {
+            if ((k.mr == mr) && (k.nr == nr)) {
+                Rgemm_simd_current<T>() = &k;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+//
+//     Run the selected kernel on an mr x nr tile of C.  Full tiles of a C
+//     already in the kernel's type are updated in place; the others are
+//     copied to a local tile (unless beta is zero), updated, and copied
+//     (converted) back.
+//
+template <typename T, typename REAL> void Rgemm_simd_run(int64_t const kc, T const alpha, T const *ap, T const *bp, T const beta, REAL *c, int64_t const ldc, int64_t const mr, int64_t const nr) {
+    Rgemm_simd_kernel<T> const &kernel = Rgemm_simd_select<T>();
+    if (std::is_same<T, REAL>::value && (mr == kernel.mr) && (nr == kernel.nr)) {
+        kernel.run(kc, alpha, ap, bp, beta, (T *)c, ldc);
+        return;
+    }
+    T ct[32 * 12];
+    if (beta != T(0)) {
+        std::memset(ct, 0, sizeof(ct));
+        for (int64_t j = 0; j < nr; j++) {
+            for (int64_t i = 0; i < mr; i++) {
+                ct[i + j * kernel.mr] = c[i + j * ldc];
+            }
+        }
+    }
+    kernel.run(kc, alpha, ap, bp, beta, ct, kernel.mr);
+    for (int64_t j = 0; j < nr; j++) {
+        for (int64_t i = 0; i < mr; i++) {
+            c[i + j * ldc] = ct[i + j * kernel.mr];
+        }
+    }
+}
+
+template <> struct Rgemm_kernel<double> {
+    typedef double packed_t;
+    static constexpr int64_t packed_size = 1;
+    static int64_t mr() { return Rgemm_simd_select<double>().mr; }
+    static int64_t nr() { return Rgemm_simd_select<double>().nr; }
+    static void pack_a(int64_t const mc, int64_t const kc, double const *a, int64_t const rsa, int64_t const csa, int64_t const mr, double *ap) { Rgemm_pack_a(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, double const *b, int64_t const rsb, int64_t const csb, int64_t const nr, double *bp) { Rgemm_pack_b(kc, nc, b, rsb, csb, nr, bp); }
+    static void run(int64_t const kc, double const &alpha, double const *ap, double const *bp, double const &beta, double *c, int64_t const ldc, int64_t const mr, int64_t const nr) { Rgemm_simd_run(kc, alpha, ap, bp, beta, c, ldc, mr, nr); }
+};
+
+template <> struct Rgemm_shapes<double> : Rgemm_simd_shapes<double> {};
+
+template <> struct Rgemm_kernel<float> {
+    typedef float packed_t;
+    static constexpr int64_t packed_size = 1;
+    static int64_t mr() { return Rgemm_simd_select<float>().mr; }
+    static int64_t nr() { return Rgemm_simd_select<float>().nr; }
+    static void pack_a(int64_t const mc, int64_t const kc, float const *a, int64_t const rsa, int64_t const csa, int64_t const mr, float *ap) { Rgemm_pack_a(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, float const *b, int64_t const rsb, int64_t const csb, int64_t const nr, float *bp) { Rgemm_pack_b(kc, nc, b, rsb, csb, nr, bp); }
+    static void run(int64_t const kc, float const &alpha, float const *ap, float const *bp, float const &beta, float *c, int64_t const ldc, int64_t const mr, int64_t const nr) { Rgemm_simd_run(kc, alpha, ap, bp, beta, c, ldc, mr, nr); }
+};
+
+template <> struct Rgemm_shapes<float> : Rgemm_simd_shapes<float> {};
+
+#ifdef __FLT16_MANT_DIG__
+//
+//     _Float16: A and B are widened to float while packing (eight at a time
+//     with F16C when op(A) is stored by columns) and the float kernel runs;
+//     C is rounded back to _Float16 once per KC block.
+//
+#pragma GCC push_options
+#pragma GCC target("f16c")
+inline float Rgemm_f16c_load(_Float16 const *p) {
+    unsigned short h;
+    std::memcpy(&h, p, sizeof(h));
+    return _cvtsh_ss(h);
+}
+
+inline void Rgemm_pack_a_f16c(int64_t const mc, int64_t const kc, _Float16 const *a, int64_t const rsa, int64_t const csa, int64_t const mr, float *ap) {
+    for (int64_t ir = 0; ir < mc; ir += mr) {
+        int64_t ib = std::min(mr, mc - ir);
+        for (int64_t l = 0; l < kc; l++) {
+            int64_t i = 0;
+            if (rsa == 1) {
+                for (; i + 8 <= ib; i += 8) {
+                    _mm256_storeu_ps(&ap[i], _mm256_cvtph_ps(_mm_loadu_si128((__m128i const *)&a[(ir + i) + l * csa])));
+                }
+            }
+            for (; i < ib; i++) {
+                ap[i] = Rgemm_f16c_load(&a[(ir + i) * rsa + l * csa]);
+            }
+            for (i = ib; i < mr; i++) {
+                ap[i] = 0.0f;
+            }
+            ap += mr;
+        }
+    }
+}
+
+inline void Rgemm_pack_b_f16c(int64_t const kc, int64_t const nc, _Float16 const *b, int64_t const rsb, int64_t const csb, int64_t const nr, float *bp) {
+    for (int64_t jr = 0; jr < nc; jr += nr) {
+        int64_t jb = std::min(nr, nc - jr);
+        for (int64_t l = 0; l < kc; l++) {
+            for (int64_t j = 0; j < jb; j++) {
+                bp[j] = Rgemm_f16c_load(&b[l * rsb + (jr + j) * csb]);
+            }
+            for (int64_t j = jb; j < nr; j++) {
+                bp[j] = 0.0f;
+            }
+            bp += nr;
+        }
+    }
+}
+#pragma GCC pop_options
+
+inline bool Rgemm_has_f16c() {
+    static const bool has = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("f16c") != 0;
+    }();
+    return has;
+}
+
+template <> struct Rgemm_blocking<_Float16> : Rgemm_blocking<float> {};
+
+template <> struct Rgemm_kernel<_Float16> {
+    typedef float packed_t;
+    static constexpr int64_t packed_size = 1;
+    static int64_t mr() { return Rgemm_simd_select<float>().mr; }
+    static int64_t nr() { return Rgemm_simd_select<float>().nr; }
+    static void pack_a(int64_t const mc, int64_t const kc, _Float16 const *a, int64_t const rsa, int64_t const csa, int64_t const mr, float *ap) {
+        if (Rgemm_has_f16c()) {
+            Rgemm_pack_a_f16c(mc, kc, a, rsa, csa, mr, ap);
+        } else {
+            Rgemm_pack_a(mc, kc, a, rsa, csa, mr, ap);
+        }
+    }
+    static void pack_b(int64_t const kc, int64_t const nc, _Float16 const *b, int64_t const rsb, int64_t const csb, int64_t const nr, float *bp) {
+        if (Rgemm_has_f16c()) {
+            Rgemm_pack_b_f16c(kc, nc, b, rsb, csb, nr, bp);
+        } else {
+            Rgemm_pack_b(kc, nc, b, rsb, csb, nr, bp);
+        }
+    }
+    static void run(int64_t const kc, _Float16 const &alpha, float const *ap, float const *bp, _Float16 const &beta, _Float16 *c, int64_t const ldc, int64_t const mr, int64_t const nr) { Rgemm_simd_run(kc, (float)alpha, ap, bp, (float)beta, c, ldc, mr, nr); }
+};
+
+//
+//     _Float16 data accumulated in float packs exactly as above.
+//
+template <> struct Rgemm_widen<_Float16, float> {
+    typedef float packed_t;
+    static void pack_a(int64_t const mc, int64_t const kc, _Float16 const *a, int64_t const rsa, int64_t const csa, int64_t const mr, float *ap) { Rgemm_kernel<_Float16>::pack_a(mc, kc, a, rsa, csa, mr, ap); }
+    static void pack_b(int64_t const kc, int64_t const nc, _Float16 const *b, int64_t const rsb, int64_t const csb, int64_t const nr, float *bp) { Rgemm_kernel<_Float16>::pack_b(kc, nc, b, rsb, csb, nr, bp); }
+};
+#endif
+} // namespace mpblas
+
+#endif
+
+#endif
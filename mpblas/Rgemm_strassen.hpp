@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Rgemm by the Strassen-Winograd algorithm (7 products and 15 additions per
+level), for element types whose multiplication is much more expensive than
+their addition.  The recursion stops below a per-type crossover size, where
+the blocked engine takes over; odd dimensions are handled by peeling the last
+row, column or inner index off and fixing it up with classical products.
+The temporaries follow the two-buffer schedule of Boyer, Dumas, Pernet and
+Zhou ("Memory efficient scheduling of Strassen-Winograd's matrix
+multiplication algorithm", 2009) and live in a per-thread buffer that is
+reused from call to call.
+Strassen-Winograd satisfies a normwise rather than an elementwise error
+bound; Mgemm_algo::classical turns it off.
+*/
+
+#ifndef ___MPBLAS_RGEMM_STRASSEN_H___
+#define ___MPBLAS_RGEMM_STRASSEN_H___
+
+#include <algorithm>
+#include "Mbuffer.hpp"
+#include "Mtypes.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     Crossover size: one level of recursion is taken while min(m, n, k) is
+//     at least crossover().  automatic tells whether Mgemm_algo::automatic
+//     uses the algorithm at all; it does not for the hardware types, whose
+//     blocked kernels are hard to beat.
+//
+template <typename REAL> struct Rgemm_strassen_traits {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static constexpr bool automatic = false;
+    static int64_t crossover() { return 1024; }
+};
+
+#ifdef __FLT128_MANT_DIG__
+template <> struct Rgemm_strassen_traits<_Float128> {
+    static constexpr bool automatic = true;
+    static int64_t crossover() { return 128; }
+};
+#endif
+
+//
+//     Crossover in use: Rgemm_strassen_traits<REAL>::crossover() unless it
+//     has been overridden by setting Rgemm_strassen_cutoff<REAL>() > 0.
+//
+template <typename REAL> int64_t &Rgemm_strassen_cutoff() {
+    static int64_t cutoff = 0;
+    return cutoff;
+}
+
+template <typename REAL> int64_t Rgemm_strassen_crossover() {
+    const int64_t cutoff = Rgemm_strassen_cutoff<REAL>();
+    return std::max((int64_t)2, (cutoff > 0) ? cutoff : Rgemm_strassen_traits<REAL>::crossover());
+}
+
+template <typename REAL> bool Rgemm_use_strassen(int64_t const m, int64_t const n, int64_t const k) { return Rgemm_strassen_traits<REAL>::automatic && (std::min(std::min(m, n), k) >= Rgemm_strassen_crossover<REAL>()); }
+
+//
+//     A strided matrix: element (i, j) at p[i * rs + j * cs].  One of the
+//     strides is always 1.
+//
+template <typename REAL> struct Rgemm_strassen_view {
+    REAL *p;
+    int64_t rs;
+    int64_t cs;
+    Rgemm_strassen_view block(int64_t const i, int64_t const j) const { return Rgemm_strassen_view{p + i * rs + j * cs, rs, cs}; }
+};
+
+//
+//     z := x + y, or x - y when sub is set.  z may be x or y.
+//
+template <typename REAL> void Rgemm_strassen_add(int64_t const m, int64_t const n, Rgemm_strassen_view<REAL> const x, Rgemm_strassen_view<REAL> const y, Rgemm_strassen_view<REAL> const z, bool const sub) {
+    for (int64_t j = 0; j < n; j++) {
+        for (int64_t i = 0; i < m; i++) {
+            if (sub) {
+                z.p[i * z.rs + j * z.cs] = x.p[i * x.rs + j * x.cs] - y.p[i * y.rs + j * y.cs];
+            } else {
+                z.p[i * z.rs + j * z.cs] = x.p[i * x.rs + j * x.cs] + y.p[i * y.rs + j * y.cs];
+            }
+        }
+    }
+}
+
+//
+//     c := a * b + beta * c with beta zero or one, on the blocked engine; c is
+//     column major.
+//
+template <typename REAL> void Rgemm_strassen_base(int64_t const m, int64_t const n, int64_t const k, Rgemm_strassen_view<REAL> const a, Rgemm_strassen_view<REAL> const b, REAL const &beta, Rgemm_strassen_view<REAL> const c) {
+    if (m == 0 || n == 0) {
+        return;
+    }
+    const REAL one = 1.0;
+    Rgemm_blocked(a.rs == 1, b.rs == 1, m, n, k, one, a.p, (a.rs == 1) ? a.cs : a.rs, b.p, (b.rs == 1) ? b.cs : b.rs, beta, c.p, c.cs);
+}
+
+//
+//     Workspace needed by Rgemm_strassen_rec for an m x n x k product.
+//
+template <typename REAL> int64_t Rgemm_strassen_work(int64_t const m, int64_t const n, int64_t const k) {
+    if (std::min(std::min(m, n), k) < Rgemm_strassen_crossover<REAL>()) {
+        return 0;
+    }
+    const int64_t mh = m / 2;
+    const int64_t nh = n / 2;
+    const int64_t kh = k / 2;
+    return mh * std::max(kh, nh) + kh * nh + Rgemm_strassen_work<REAL>(mh, nh, kh);
+}
+
+//
+//     c := a * b (m x k times k x n); work holds Rgemm_strassen_work(m, n, k)
+//     elements.
+//
+template <typename REAL> void Rgemm_strassen_rec(int64_t const m, int64_t const n, int64_t const k, Rgemm_strassen_view<REAL> const a, Rgemm_strassen_view<REAL> const b, Rgemm_strassen_view<REAL> const c, REAL *work) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    if (std::min(std::min(m, n), k) < Rgemm_strassen_crossover<REAL>()) {
+        Rgemm_strassen_base(m, n, k, a, b, zero, c);
+        return;
+    }
+    const int64_t mh = m / 2;
+    const int64_t nh = n / 2;
+    const int64_t kh = k / 2;
+    Rgemm_strassen_view<REAL> a11 = a, a12 = a.block(0, kh), a21 = a.block(mh, 0), a22 = a.block(mh, kh);
+    Rgemm_strassen_view<REAL> b11 = b, b12 = b.block(0, nh), b21 = b.block(kh, 0), b22 = b.block(kh, nh);
+    Rgemm_strassen_view<REAL> c11 = c, c12 = c.block(0, nh), c21 = c.block(mh, 0), c22 = c.block(mh, nh);
+    //
+    //     X is mh x max(kh, nh), Y is kh x nh, both column major.
+    //
+    Rgemm_strassen_view<REAL> x{work, 1, mh};
+    Rgemm_strassen_view<REAL> y{work + mh * std::max(kh, nh), 1, kh};
+    REAL *rest = work + mh * std::max(kh, nh) + kh * nh;
+    //
+    //     S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2,
+    //     T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21,
+    //     P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4,
+    //     P5 = S1 T1,   P6 = S2 T2,   P7 = S3 T3,
+    //     C11 = P1 + P2, C12 = P1 + P6 + P5 + P3,
+    //     C21 = P1 + P6 + P7 - P4, C22 = P1 + P6 + P7 + P5.
+    //
+    Rgemm_strassen_add(mh, kh, a11, a21, x, true);
+    Rgemm_strassen_add(kh, nh, b22, b12, y, true);
+    Rgemm_strassen_rec(mh, nh, kh, x, y, c21, rest);
+    Rgemm_strassen_add(mh, kh, a21, a22, x, false);
+    Rgemm_strassen_add(kh, nh, b12, b11, y, true);
+    Rgemm_strassen_rec(mh, nh, kh, x, y, c22, rest);
+    Rgemm_strassen_add(mh, kh, x, a11, x, true);
+    Rgemm_strassen_add(kh, nh, b22, y, y, true);
+    Rgemm_strassen_rec(mh, nh, kh, x, y, c12, rest);
+    Rgemm_strassen_add(mh, kh, a12, x, x, true);
+    Rgemm_strassen_rec(mh, nh, kh, x, b22, c11, rest);
+    Rgemm_strassen_rec(mh, nh, kh, a11, b11, x, rest);
+    Rgemm_strassen_add(mh, nh, x, c12, c12, false);
+    Rgemm_strassen_add(mh, nh, c12, c21, c21, false);
+    Rgemm_strassen_add(mh, nh, c12, c22, c12, false);
+    Rgemm_strassen_add(mh, nh, c21, c22, c22, false);
+    Rgemm_strassen_add(mh, nh, c12, c11, c12, false);
+    Rgemm_strassen_add(kh, nh, y, b21, y, true);
+    Rgemm_strassen_rec(mh, nh, kh, a22, y, c11, rest);
+    Rgemm_strassen_add(mh, nh, c21, c11, c21, true);
+    Rgemm_strassen_rec(mh, nh, kh, a12, b21, c11, rest);
+    Rgemm_strassen_add(mh, nh, x, c11, c11, false);
+    //
+    //     Peel off what the even part left out.
+    //
+    if (k > 2 * kh) {
+        Rgemm_strassen_base(2 * mh, 2 * nh, (int64_t)1, a.block(0, k - 1), b.block(k - 1, 0), one, c);
+    }
+    if (n > 2 * nh) {
+        Rgemm_strassen_base(m, (int64_t)1, k, a, b.block(0, n - 1), zero, c.block(0, n - 1));
+    }
+    if (m > 2 * mh) {
+        Rgemm_strassen_base((int64_t)1, 2 * nh, k, a.block(m - 1, 0), b, zero, c.block(m - 1, 0));
+    }
+}
+
+template <typename REAL> void Rgemm_strassen(bool const nota, bool const notb, int64_t const m, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    thread_local Mbuffer<REAL> buffer;
+    const int64_t nwork = Rgemm_strassen_work<REAL>(m, n, k);
+    const bool direct = (beta == zero);
+    REAL *work = buffer.reserve(nwork + (direct ? 0 : m * n));
+    Rgemm_strassen_view<REAL> av{a, nota ? 1 : lda, nota ? lda : 1};
+    Rgemm_strassen_view<REAL> bv{b, notb ? 1 : ldb, notb ? ldb : 1};
+    if (direct) {
+        //
+        //     C := op(A) * op(B), then C := alpha * C.
+        //
+        Rgemm_strassen_rec(m, n, k, av, bv, Rgemm_strassen_view<REAL>{c, 1, ldc}, work);
+        if (alpha != one) {
+            for (int64_t j = 0; j < n; j++) {
+                for (int64_t i = 0; i < m; i++) {
+                    c[i + j * ldc] = alpha * c[i + j * ldc];
+                }
+            }
+        }
+    } else {
+        //
+        //     P := op(A) * op(B), then C := alpha * P + beta * C.
+        //
+        REAL *p = work + nwork;
+        Rgemm_strassen_rec(m, n, k, av, bv, Rgemm_strassen_view<REAL>{p, 1, m}, work);
+        for (int64_t j = 0; j < n; j++) {
+            for (int64_t i = 0; i < m; i++) {
+                c[i + j * ldc] = alpha * p[i + j * m] + beta * c[i + j * ldc];
+            }
+        }
+    }
+}
+} // namespace mpblas
+
+#endif
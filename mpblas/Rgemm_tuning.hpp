@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Per-machine tuning of the blocked engine.
+The tuning file is read once, the first time a blocked product needs it.  It
+is named by the environment variable MPBLAS_TUNING, or is mpblas_tuning.txt
+in the working directory; a missing file leaves the built-in defaults.  Each
+line, as written by Rgemm_tune, is
+    <type> <format> <mc> <kc> <nc> <mr> <nr>
+where <type> is Rgemm_tuning_name<REAL>::name(), <format> is
+Mbuffer_format<REAL>::current() (the precision in bits for mpf_class, 0 for
+the other types), mc x kc x nc are the cache blocks and mr x nr the register
+tile.  A zero keeps the default; the register tile only applies to kernels
+that offer a choice of shapes (Rgemm_shapes).  Lines starting with # are
+comments.
+*/
+
+#ifndef ___MPBLAS_RGEMM_TUNING_H___
+#define ___MPBLAS_RGEMM_TUNING_H___
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include "Mbuffer.hpp"
+#include "Mtypes.hpp"
+
+namespace mpblas {
+
+struct Rgemm_tuning {
+    int64_t mc = 0;
+    int64_t kc = 0;
+    int64_t nc = 0;
+    int64_t mr = 0;
+    int64_t nr = 0;
+};
+
+//
+//     Name of REAL in the tuning file.
+//
+template <typename REAL> struct Rgemm_tuning_name {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    static const char *name() { return typeid(REAL).name(); }
+};
+template <> struct Rgemm_tuning_name<float> {
+    static const char *name() { return "float"; }
+};
+template <> struct Rgemm_tuning_name<double> {
+    static const char *name() { return "double"; }
+};
+#ifdef __FLT16_MANT_DIG__
+template <> struct Rgemm_tuning_name<_Float16> {
+    static const char *name() { return "_Float16"; }
+};
+#endif
+#ifdef __FLT128_MANT_DIG__
+template <> struct Rgemm_tuning_name<_Float128> {
+    static const char *name() { return "_Float128"; }
+};
+#endif
+
+struct Rgemm_tuning_entry {
+    std::string name;
+    uint64_t format;
+    Rgemm_tuning tuning;
+};
+
+inline const char *Rgemm_tuning_file() {
+    const char *file = std::getenv("MPBLAS_TUNING");
+    return ((file != nullptr) && (*file != '\0')) ? file : "mpblas_tuning.txt";
+}
+
+//
+//     The entries of a tuning file (none if it cannot be read).
+//
+inline std::vector<Rgemm_tuning_entry> Rgemm_tuning_read(const char *file) {
+    std::vector<Rgemm_tuning_entry> entries;
+    FILE *fp = std::fopen(file, "r");
+    if (fp == nullptr) {
+        return entries;
+    }
+    char line[512];
+    while (std::fgets(line, sizeof(line), fp) != nullptr) {
+        char name[256];
+        unsigned long long format = 0;
+        long long v[5] = {0, 0, 0, 0, 0};
+        if ((line[0] == '#') || (std::sscanf(line, "%255s %llu %lld %lld %lld %lld %lld", name, &format, &v[0], &v[1], &v[2], &v[3], &v[4]) != 7)) {
+            continue;
+        }
+        Rgemm_tuning t;
+        t.mc = std::max((long long)0, v[0]);
+        t.kc = std::max((long long)0, v[1]);
+        t.nc = std::max((long long)0, v[2]);
+        t.mr = std::max((long long)0, v[3]);
+        t.nr = std::max((long long)0, v[4]);
+        entries.push_back(Rgemm_tuning_entry{name, (uint64_t)format, t});
+    }
+    std::fclose(fp);
+    return entries;
+}
+
+//
+//     The entries of the tuning file, read on the first call.
+//
+inline std::vector<Rgemm_tuning_entry> const &Rgemm_tuning_table() {
+    static const std::vector<Rgemm_tuning_entry> table = Rgemm_tuning_read(Rgemm_tuning_file());
+    return table;
+}
+
+inline Rgemm_tuning Rgemm_tuning_find(const char *name, uint64_t const format) {
+    for (Rgemm_tuning_entry const &e : Rgemm_tuning_table()) {
+        if ((e.format == format) && (std::strcmp(e.name.c_str(), name) == 0)) {
+            return e.tuning;
+        }
+    }
+    return Rgemm_tuning();
+}
+
+//
+//     Overrides set by the program (Rgemm_tune sets them while it searches);
+//     a nonzero field takes precedence over the tuning file.
+//
+template <typename REAL> Rgemm_tuning &Rgemm_tuning_override() {
+    static Rgemm_tuning tuning;
+    return tuning;
+}
+
+//
+//     Tuning of REAL at the current format: the override, then the file.
+//     The file lookup is cached per thread and format.
+//
+template <typename REAL> Rgemm_tuning Rgemm_tuned() {
+    thread_local bool cached = false;
+    thread_local uint64_t format = 0;
+    thread_local Rgemm_tuning file;
+    const uint64_t current = Mbuffer_format<REAL>::current();
+    if ((!cached) || (format != current)) {
+        file = Rgemm_tuning_find(Rgemm_tuning_name<REAL>::name(), current);
+        format = current;
+        cached = true;
+    }
+    Rgemm_tuning const &o = Rgemm_tuning_override<REAL>();
+    Rgemm_tuning t;
+    t.mc = (o.mc > 0) ? o.mc : file.mc;
+    t.kc = (o.kc > 0) ? o.kc : file.kc;
+    t.nc = (o.nc > 0) ? o.nc : file.nc;
+    t.mr = (o.mr > 0) ? o.mr : file.mr;
+    t.nr = (o.nr > 0) ? o.nr : file.nr;
+    return t;
+}
+} // namespace mpblas
+
+#endif
@@ -26,18 +26,32 @@
  *
  */
 
+#ifndef ___MPBLAS_RGEMV_H___
+#define ___MPBLAS_RGEMV_H___
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "Mbuffer.hpp"
+#include "Mgather.hpp"
 #include "Mlsame.hpp"
 #include "Mxerbla.hpp"
+#include "Mtrans.hpp"
+#include "Rgemv_blocked.hpp"
 
 namespace mpblas {
-template <typename REAL> void Rgemv(const char *trans, int64_t const m, int64_t const n, REAL const alpha, REAL *a, int64_t const lda, REAL *x, int64_t const incx, REAL const beta, REAL *y, int64_t const incy) {
+
+//
+//     Rgemv with the transpose mode as a template parameter:
+//       Rgemv<Mtrans::T>(m, n, alpha, a, lda, x, incx, beta, y, incy)
+//     The other arguments and the error codes are those of Rgemv below.
+//
+template <Mtrans TRANS, typename REAL> void Rgemv(int64_t const m, int64_t const n, std::type_identity_t<REAL> const &alpha, REAL *a, int64_t const lda, REAL *x, int64_t const incx, std::type_identity_t<REAL> const &beta, REAL *y, int64_t const incy) {
     //
     //     Test the input parameters.
     //
     int64_t info = 0;
-    if (!Mlsame(trans, "N") && !Mlsame(trans, "T") && !Mlsame(trans, "C")) {
-        info = 1;
-    } else if (m < 0) {
+    if (m < 0) {
         info = 2;
     } else if (n < 0) {
         info = 3;
@@ -61,125 +75,55 @@ template <typename REAL> void Rgemv(const char *trans, int64_t const m, int64_t
         return;
     }
     //
-    //     Set  LENX  and  LENY, the lengths of the vectors x and y, and set
-    //     up the start points in  X  and  Y.
-    //
-    int64_t lenx = 0;
-    int64_t leny = 0;
-    if (Mlsame(trans, "N")) {
-        lenx = n;
-        leny = m;
-    } else {
-        lenx = m;
-        leny = n;
-    }
-    int64_t kx = 0;
-    if (incx > 0) {
-        kx = 1;
-    } else {
-        kx = 1 - (lenx - 1) * incx;
-    }
-    int64_t ky = 0;
-    if (incy > 0) {
-        ky = 1;
-    } else {
-        ky = 1 - (leny - 1) * incy;
-    }
+    //     Start the operations.  The blocked loops need unit stride in the
+    //     vector the inner loop runs over: y for "N", x for "T".  A strided
+    //     one is gathered into a contiguous per-thread buffer first (y is not
+    //     read when beta is zero) and y is scattered back afterwards.
     //
-    //     Start the operations. In this version the elements of A are
-    //     accessed sequentially with one pass through A.
-    //
-    //     First form  y := beta*y.
-    //
-    int64_t i = 0;
-    int64_t iy = 0;
-    if (beta != one) {
+    thread_local Mbuffer<REAL> buffer;
+    if constexpr (TRANS == Mtrans::N) {
         if (incy == 1) {
-            if (beta == zero) {
-                for (i = 1; i <= leny; i = i + 1) {
-                    y[i - 1] = zero;
-                }
-            } else {
-                for (i = 1; i <= leny; i = i + 1) {
-                    y[i - 1] = beta * y[i - 1];
-                }
-            }
+            Rgemv_blocked<Mtrans::N>(m, n, alpha, a, lda, x, incx, beta, y, incy);
         } else {
-            iy = ky;
-            if (beta == zero) {
-                for (i = 1; i <= leny; i = i + 1) {
-                    y[iy - 1] = zero;
-                    iy += incy;
-                }
-            } else {
-                for (i = 1; i <= leny; i = i + 1) {
-                    y[iy - 1] = beta * y[iy - 1];
-                    iy += incy;
-                }
-            }
-        }
-    }
-    if (alpha == zero) {
-        return;
-    }
-    int64_t jx = 0;
-    int64_t j = 0;
-    REAL temp = 0.0;
-    int64_t jy = 0;
-    int64_t ix = 0;
-    if (Mlsame(trans, "N")) {
-        //
-        //        Form  y := alpha*A*x + y.
-        //
-        jx = kx;
-        if (incy == 1) {
-            for (j = 1; j <= n; j = j + 1) {
-                temp = alpha * x[jx - 1];
-                for (i = 1; i <= m; i = i + 1) {
-                    y[i - 1] += temp * a[(i - 1) + (j - 1) * lda];
-                }
-                jx += incx;
-            }
-        } else {
-            for (j = 1; j <= n; j = j + 1) {
-                temp = alpha * x[jx - 1];
-                iy = ky;
-                for (i = 1; i <= m; i = i + 1) {
-                    y[iy - 1] += temp * a[(i - 1) + (j - 1) * lda];
-                    iy += incy;
-                }
-                jx += incx;
+            REAL *w = buffer.reserve(m);
+            if (beta != zero) {
+                Mgather(m, y, incy, w);
             }
+            Rgemv_blocked<Mtrans::N>(m, n, alpha, a, lda, x, incx, beta, w, (int64_t)1);
+            Mscatter(m, w, y, incy);
         }
     } else {
-        //
-        //        Form  y := alpha*A**T*x + y.
-        //
-        jy = ky;
         if (incx == 1) {
-            for (j = 1; j <= n; j = j + 1) {
-                temp = zero;
-                for (i = 1; i <= m; i = i + 1) {
-                    temp += a[(i - 1) + (j - 1) * lda] * x[i - 1];
-                }
-                y[jy - 1] += alpha * temp;
-                jy += incy;
-            }
+            Rgemv_blocked<Mtrans::T>(m, n, alpha, a, lda, x, incx, beta, y, incy);
         } else {
-            for (j = 1; j <= n; j = j + 1) {
-                temp = zero;
-                ix = kx;
-                for (i = 1; i <= m; i = i + 1) {
-                    temp += a[(i - 1) + (j - 1) * lda] * x[ix - 1];
-                    ix += incx;
-                }
-                y[jy - 1] += alpha * temp;
-                jy += incy;
-            }
+            REAL *w = buffer.reserve(m);
+            Mgather(m, x, incx, w);
+            Rgemv_blocked<Mtrans::T>(m, n, alpha, a, lda, w, (int64_t)1, beta, y, incy);
         }
     }
+}
+
+template <typename REAL> void Rgemv(const char *trans, int64_t const m, int64_t const n, REAL const alpha, REAL *a, int64_t const lda, REAL *x, int64_t const incx, REAL const beta, REAL *y, int64_t const incy) {
+    //
+    //     Test the input parameters.
+    //
+    Mtrans t = Mtrans::N;
+    if (!Mtrans_parse(trans, t)) {
+        Mxerbla("Rgemv ", 1);
+        return;
+    }
+    //
+    //     The rest is done by the typed Rgemv; for a real matrix C is T.
+    //
+    if (t == Mtrans::N) {
+        Rgemv<Mtrans::N>(m, n, alpha, a, lda, x, incx, beta, y, incy);
+    } else {
+        Rgemv<Mtrans::T>(m, n, alpha, a, lda, x, incx, beta, y, incy);
+    }
     //
     //     End of Rgemv.
     //
 }
-}
+} // namespace mpblas
+
+#endif
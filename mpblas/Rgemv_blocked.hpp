@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Blocked loops of Rgemv for unit-stride y ("N") or x ("T").
+"N": y := beta*y is formed first, then A is swept by blocks of columns.  For
+each element of y, the contributions of all the columns of a block are added
+while it is held in a register, so y is loaded and stored once per block
+instead of once per column.  The contributions are added in the order of
+the columns, as in the column-by-column loop of the reference BLAS, so the
+results are the same (for qd_real, whose multiply-add is that of the blocked
+Rgemm kernels, up to the last bits).
+"T": a block of columns is multiplied with x at once, so every element of x
+that is loaded is used for all the columns of the block, and each of the dot
+products is split over several accumulators (element i goes to accumulator
+i mod the number of accumulators).  The chains of dependent additions are
+shorter and independent of each other, which hides the latency of the add.
+The accumulators are summed pairwise at the end; the results may differ from
+those of the reference BLAS in the last bits.
+With OpenMP, "N" gives each thread a range of rows of y and "T" a range of
+columns of A, so every element of y is computed as in the serial code.  A
+"T" product with few columns and many rows is instead cut into row parts,
+whether threaded or not; their number depends only on m and n, each part's
+dot products go to a separate buffer and the buffers are summed pairwise, so
+the result is the same for any number of threads.
+*/
+
+#ifndef ___MPBLAS_RGEMV_BLOCKED_H___
+#define ___MPBLAS_RGEMV_BLOCKED_H___
+
+#include <algorithm>
+#include <cstdint>
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Mtrans.hpp"
+#include "Mtypes.hpp"
+#include "Rgemm_fixed.hpp"
+
+namespace mpblas {
+
+//
+//     Blocking parameters: the number of columns of a block and the number of
+//     accumulators of each dot product in the "T" case.  Each OpenMP thread is
+//     given at least work_per_thread multiply-adds, and the rows of y ("N") or
+//     of the parts of x ("T") it gets are multiples of align, a cache line.
+//     "T" products with fewer than split_columns columns are cut into at
+//     most max_parts row parts.
+//
+template <typename REAL> struct Rgemv_blocking {
+    static constexpr int64_t columns = 4;
+    static constexpr int64_t accumulators = 4;
+    static constexpr int64_t work_per_thread = (sizeof(REAL) <= 8) ? 65536 : 4096;
+    static constexpr int64_t align = std::max((int64_t)1, (int64_t)(64 / sizeof(REAL)));
+    static constexpr int64_t split_columns = 64;
+    static constexpr int64_t max_parts = 64;
+};
+
+//
+//     The loops over a block of NC columns for element type REAL; specialized
+//     for the libqd types in qd.hpp.
+//       n_block: y := y + t(0)*A(:,0) + ... + t(NC-1)*A(:,NC-1), y of length m
+//       t_block: s(c) := A(:,c)**T*x for c = 0, ..., NC-1, x of length m
+//
+template <typename REAL> struct Rgemv_blocked_kernel {
+    static_assert(Mtype_ready<REAL>, "include mpblas/qd.hpp or mpblas/gmp.hpp for this element type");
+    template <int64_t NC> static void n_block(int64_t const m, REAL const *t, REAL const *a, int64_t const lda, REAL *y) {
+        for (int64_t i = 0; i < m; i++) {
+            REAL yi = y[i];
+#pragma GCC unroll 16
+            for (int64_t c = 0; c < NC; c++) {
+                yi += t[c] * a[c * lda + i];
+            }
+            y[i] = yi;
+        }
+    }
+    template <int64_t NC, int64_t NA> static void t_block(int64_t const m, REAL const *a, int64_t const lda, REAL const *x, REAL *s) {
+        const REAL zero = 0.0;
+        REAL acc[NC][NA];
+        for (int64_t c = 0; c < NC; c++) {
+            for (int64_t q = 0; q < NA; q++) {
+                acc[c][q] = zero;
+            }
+        }
+        const int64_t mb = m - m % NA;
+        int64_t i = 0;
+        for (i = 0; i < mb; i += NA) {
+#pragma GCC unroll 16
+            for (int64_t c = 0; c < NC; c++) {
+#pragma GCC unroll 16
+                for (int64_t q = 0; q < NA; q++) {
+                    acc[c][q] += a[c * lda + i + q] * x[i + q];
+                }
+            }
+        }
+        for (; i < m; i++) {
+            for (int64_t c = 0; c < NC; c++) {
+                acc[c][i - mb] += a[c * lda + i] * x[i];
+            }
+        }
+        for (int64_t c = 0; c < NC; c++) {
+            for (int64_t w = 1; w < NA; w *= 2) {
+                for (int64_t q = 0; q + w < NA; q += 2 * w) {
+                    acc[c][q] += acc[c][q + w];
+                }
+            }
+            s[c] = acc[c][0];
+        }
+    }
+};
+
+//
+//     The same for dd_real and qd_real, with the elements held as separate
+//     doubles for each limb and updated with the multiply-add of the blocked
+//     Rgemm kernels, which is libqd's multiply followed by its add.  In
+//     n_block the rows go through Rgemv_kernel_n (Rgemm_qd.hpp) a group of
+//     SIMD lanes at a time, and only the last few one by one: a single row
+//     would be a chain of NC dependent multiply-adds.
+//
+template <typename REAL, int LIMBS> struct Rgemv_blocked_limbs {
+    typedef Rgemm_fixed_limbs<REAL, LIMBS> limbs;
+    static_assert(sizeof(REAL) == LIMBS * sizeof(double), "the limbs of REAL must be its only members");
+    template <int64_t NC> static void n_block(int64_t const m, REAL const *t, REAL const *a, int64_t const lda, REAL *y) {
+        double tl[NC][LIMBS];
+        for (int64_t c = 0; c < NC; c++) {
+            limbs::load(t[c], tl[c]);
+        }
+        int64_t i = Rgemv_qd_kernel_n<LIMBS, NC>()(m, &tl[0][0], reinterpret_cast<double const *>(a), lda, reinterpret_cast<double *>(y));
+        for (; i < m; i++) {
+            double yl[LIMBS];
+            limbs::load(y[i], yl);
+            for (int64_t c = 0; c < NC; c++) {
+                double al[LIMBS];
+                limbs::load(a[c * lda + i], al);
+                limbs::madd(tl[c], al, yl);
+            }
+            y[i] = limbs::value(yl);
+        }
+    }
+    template <int64_t NC, int64_t NA> static void t_block(int64_t const m, REAL const *a, int64_t const lda, REAL const *x, REAL *s) {
+        double acc[NC][NA][LIMBS] = {};
+        const int64_t mb = m - m % NA;
+        int64_t i = 0;
+        for (i = 0; i < mb; i += NA) {
+            for (int64_t q = 0; q < NA; q++) {
+                double xl[LIMBS];
+                limbs::load(x[i + q], xl);
+                for (int64_t c = 0; c < NC; c++) {
+                    double al[LIMBS];
+                    limbs::load(a[c * lda + i + q], al);
+                    limbs::madd(al, xl, acc[c][q]);
+                }
+            }
+        }
+        for (; i < m; i++) {
+            double xl[LIMBS];
+            limbs::load(x[i], xl);
+            for (int64_t c = 0; c < NC; c++) {
+                double al[LIMBS];
+                limbs::load(a[c * lda + i], al);
+                limbs::madd(al, xl, acc[c][i - mb]);
+            }
+        }
+        for (int64_t c = 0; c < NC; c++) {
+            REAL sum[NA];
+            for (int64_t q = 0; q < NA; q++) {
+                sum[q] = limbs::value(acc[c][q]);
+            }
+            for (int64_t w = 1; w < NA; w *= 2) {
+                for (int64_t q = 0; q + w < NA; q += 2 * w) {
+                    sum[q] += sum[q + w];
+                }
+            }
+            s[c] = sum[0];
+        }
+    }
+};
+
+//
+//     y := alpha*op(A)*x + beta*y with incy = 1 ("N") or incx = 1 ("T").  The
+//     other increment may be anything but zero; the arguments are those of
+//     Rgemv and are not checked.
+//
+template <Mtrans TRANS, typename REAL> void Rgemv_update(int64_t const m, int64_t const n, REAL const &alpha, REAL const *a, int64_t const lda, REAL const *x, int64_t const incx, REAL const &beta, REAL *y, int64_t const incy) {
+    constexpr int64_t NC = Rgemv_blocking<REAL>::columns;
+    constexpr int64_t NA = Rgemv_blocking<REAL>::accumulators;
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    constexpr bool nota = (TRANS == Mtrans::N);
+    const int64_t lenx = nota ? n : m;
+    const int64_t leny = nota ? m : n;
+    const int64_t kx = (incx > 0) ? 0 : -(lenx - 1) * incx;
+    const int64_t ky = (incy > 0) ? 0 : -(leny - 1) * incy;
+    //
+    //     First form  y := beta*y.
+    //
+    if (beta != one) {
+        int64_t iy = ky;
+        for (int64_t i = 0; i < leny; i++) {
+            if (beta == zero) {
+                y[iy] = zero;
+            } else {
+                y[iy] = beta * y[iy];
+            }
+            iy += incy;
+        }
+    }
+    if (alpha == zero) {
+        return;
+    }
+    REAL t[NC];
+    int64_t j = 0;
+    if constexpr (nota) {
+        //
+        //        Form  y := alpha*A*x + y, NC columns at a time.
+        //
+        int64_t jx = kx;
+        for (j = 0; j + NC <= n; j += NC) {
+            for (int64_t c = 0; c < NC; c++) {
+                t[c] = alpha * x[jx];
+                jx += incx;
+            }
+            Rgemv_blocked_kernel<REAL>::template n_block<NC>(m, t, &a[j * lda], lda, y);
+        }
+        for (; j < n; j++) {
+            t[0] = alpha * x[jx];
+            Rgemv_blocked_kernel<REAL>::template n_block<1>(m, t, &a[j * lda], lda, y);
+            jx += incx;
+        }
+    } else {
+        //
+        //        Form  y := alpha*A**T*x + y, NC columns at a time.
+        //
+        int64_t jy = ky;
+        for (j = 0; j + NC <= n; j += NC) {
+            Rgemv_blocked_kernel<REAL>::template t_block<NC, NA>(m, &a[j * lda], lda, x, t);
+            for (int64_t c = 0; c < NC; c++) {
+                y[jy] += alpha * t[c];
+                jy += incy;
+            }
+        }
+        for (; j < n; j++) {
+            Rgemv_blocked_kernel<REAL>::template t_block<1, NA>(m, &a[j * lda], lda, x, t);
+            y[jy] += alpha * t[0];
+            jy += incy;
+        }
+    }
+}
+
+//
+//     Elements i0, ..., i1 - 1 of the vector of length len at v with increment
+//     inc, as a vector with the same increment.
+//
+template <typename REAL> REAL *Rgemv_part(REAL *v, int64_t const len, int64_t const inc, int64_t const i0, int64_t const i1) {
+    return (inc > 0) ? &v[i0 * inc] : &v[(len - i1) * -inc];
+}
+
+//
+//     Number of row parts of a "T" product: one when there are enough columns
+//     to share among threads, else enough for the threads to have
+//     work_per_thread each.  It depends on the shape only.
+//
+template <typename REAL> int64_t Rgemv_t_parts(int64_t const m, int64_t const n) {
+    if (n >= Rgemv_blocking<REAL>::split_columns) {
+        return 1;
+    }
+    const int64_t rmin = std::max(Rgemv_blocking<REAL>::align, Rgemv_blocking<REAL>::work_per_thread / std::max(n, (int64_t)1));
+    return std::max((int64_t)1, std::min(Rgemv_blocking<REAL>::max_parts, m / rmin));
+}
+
+//
+//     Rgemv_update on as many threads as the size is worth; the arguments are
+//     the same.
+//
+template <Mtrans TRANS, typename REAL> void Rgemv_blocked(int64_t const m, int64_t const n, REAL const &alpha, REAL const *a, int64_t const lda, REAL const *x, int64_t const incx, REAL const &beta, REAL *y, int64_t const incy) {
+    constexpr int64_t NC = Rgemv_blocking<REAL>::columns;
+    constexpr int64_t align = Rgemv_blocking<REAL>::align;
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), m * n / Rgemv_blocking<REAL>::work_per_thread);
+    if (alpha == zero) {
+        Rgemv_update<TRANS>(m, n, alpha, a, lda, x, incx, beta, y, incy);
+        return;
+    }
+    const int64_t parts = (TRANS == Mtrans::N) ? 1 : Rgemv_t_parts<REAL>(m, n);
+    if (parts < 2) {
+        if (nthreads <= 1) {
+            Rgemv_update<TRANS>(m, n, alpha, a, lda, x, incx, beta, y, incy);
+        } else if constexpr (TRANS == Mtrans::N) {
+            Mparallel_tiles(m, 1, align, 1, nthreads, [&](int64_t const i0, int64_t const i1, int64_t const, int64_t const) { Rgemv_update<Mtrans::N>(i1 - i0, n, alpha, &a[i0], lda, x, incx, beta, &y[i0], (int64_t)1); }, Rgemm_tasks_per_thread<REAL>());
+        } else {
+            Mparallel_tiles(1, n, 1, NC, nthreads, [&](int64_t const, int64_t const, int64_t const j0, int64_t const j1) { Rgemv_update<Mtrans::T>(m, j1 - j0, alpha, &a[j0 * lda], lda, x, (int64_t)1, beta, Rgemv_part(y, n, incy, j0, j1), incy); }, Rgemm_tasks_per_thread<REAL>());
+        }
+        return;
+    }
+    if constexpr (TRANS != Mtrans::N) {
+        //
+        //     The dot products of the parts, W_s at w + s*n, then their
+        //     pairwise sums and the update of y, which is not read when beta
+        //     is zero.
+        //
+        thread_local Mbuffer<REAL> buffer;
+        REAL *w = buffer.reserve(parts * n);
+        Mparallel_tasks(parts, nthreads, [&](int64_t const s) {
+            const int64_t r0 = Mtile_start(s, parts, m, align);
+            const int64_t r1 = Mtile_start(s + 1, parts, m, align);
+            Rgemv_update<Mtrans::T>(r1 - r0, n, one, &a[r0], lda, &x[r0], (int64_t)1, zero, &w[s * n], (int64_t)1);
+        });
+        int64_t jy = (incy > 0) ? 0 : -(n - 1) * incy;
+        for (int64_t j = 0; j < n; j++) {
+            for (int64_t step = 1; step < parts; step *= 2) {
+                for (int64_t s = 0; s + step < parts; s += 2 * step) {
+                    w[s * n + j] += w[(s + step) * n + j];
+                }
+            }
+            if (beta == zero) {
+                y[jy] = alpha * w[j];
+            } else {
+                y[jy] = alpha * w[j] + beta * y[jy];
+            }
+            jy += incy;
+        }
+    }
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef ___MPBLAS_RSYMM_H___
+#define ___MPBLAS_RSYMM_H___
+
+#include <algorithm>
+#include <cstdint>
+#include "Mbuffer.hpp"
+#include "Mlsame.hpp"
+#include "Mxerbla.hpp"
+#include "Mtrans.hpp"
+#include "Rgemm.hpp"
+
+namespace mpblas {
+
+//
+//     C := alpha*A*B + beta*C (left) or C := alpha*B*A + beta*C (right) for
+//     the ka x ka symmetric A stored in its upper or lower triangle, after
+//     the argument checks; alpha is nonzero.  A is expanded KC columns
+//     (left) or rows (right) at a time into a full panel, which is
+//     multiplied by the blocked engine (Rgemm_blocked, in parallel) or, for
+//     small problems, by the reference loops; beta goes with the first
+//     panel.  The panels hold ka*KC elements, not ka*ka.
+//
+template <typename REAL> void Rsymm_panels(bool const left, bool const upper, int64_t const m, int64_t const n, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL one = 1.0;
+    const int64_t ka = left ? m : n;
+    int64_t MC = 0;
+    int64_t KC = 0;
+    int64_t NC = 0;
+    Rgemm_blocks<REAL>(Rgemm_kernel<REAL>::mr(), Rgemm_kernel<REAL>::nr(), MC, KC, NC);
+    const bool blocked = Rgemm_use_blocked<REAL>(m, n, ka);
+    thread_local Mbuffer<REAL> buffer;
+    REAL *w = buffer.reserve(ka * std::min(KC, ka));
+    //
+    //     Element (i, j) of A from the stored triangle.
+    //
+    auto sym = [&](int64_t const i, int64_t const j) -> REAL const & { return ((i <= j) == upper) ? a[i + j * lda] : a[j + i * lda]; };
+    for (int64_t pc = 0; pc < ka; pc += KC) {
+        const int64_t kc = std::min(KC, ka - pc);
+        REAL const &betapc = (pc == 0) ? beta : one;
+        if (left) {
+            //
+            //     W = A(:, pc:pc+kc-1), m x kc; C := alpha*W*B(pc:pc+kc-1, :) + betapc*C.
+            //
+            for (int64_t l = 0; l < kc; l++) {
+                for (int64_t i = 0; i < m; i++) {
+                    w[i + l * m] = sym(i, pc + l);
+                }
+            }
+            if (blocked) {
+                Rgemm_blocked(true, true, m, n, kc, alpha, w, m, &b[pc], ldb, betapc, c, ldc);
+            } else {
+                Rgemm_reference<Mtrans::N, Mtrans::N>(m, n, kc, alpha, w, m, &b[pc], ldb, betapc, c, ldc);
+            }
+        } else {
+            //
+            //     W = A(pc:pc+kc-1, :), kc x n; C := alpha*B(:, pc:pc+kc-1)*W + betapc*C.
+            //
+            for (int64_t j = 0; j < n; j++) {
+                for (int64_t l = 0; l < kc; l++) {
+                    w[l + j * kc] = sym(pc + l, j);
+                }
+            }
+            if (blocked) {
+                Rgemm_blocked(true, true, m, n, kc, alpha, &b[pc * ldb], ldb, w, kc, betapc, c, ldc);
+            } else {
+                Rgemm_reference<Mtrans::N, Mtrans::N>(m, n, kc, alpha, &b[pc * ldb], ldb, w, kc, betapc, c, ldc);
+            }
+        }
+    }
+}
+
+//
+//     C := alpha*A*B + beta*C (side = 'L') or C := alpha*B*A + beta*C
+//     (side = 'R'), C and B being m x n and A symmetric, m x m or n x n, and
+//     stored in its upper or lower triangle (uplo).
+//
+template <typename REAL> void Rsymm(const char *side, const char *uplo, int64_t const m, int64_t const n, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const bool left = Mlsame(side, "L");
+    const bool upper = Mlsame(uplo, "U");
+    const int64_t nrowa = left ? m : n;
+    //
+    //     Test the input parameters.
+    //
+    int64_t info = 0;
+    if ((!left) && (!Mlsame(side, "R"))) {
+        info = 1;
+    } else if ((!upper) && (!Mlsame(uplo, "L"))) {
+        info = 2;
+    } else if (m < 0) {
+        info = 3;
+    } else if (n < 0) {
+        info = 4;
+    } else if (lda < std::max((int64_t)1, nrowa)) {
+        info = 7;
+    } else if (ldb < std::max((int64_t)1, m)) {
+        info = 9;
+    } else if (ldc < std::max((int64_t)1, m)) {
+        info = 12;
+    }
+    if (info != 0) {
+        Mxerbla("Rsymm ", info);
+        return;
+    }
+    //
+    //     Quick return if possible.
+    //
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    if ((m == 0) || (n == 0) || ((alpha == zero) && (beta == one))) {
+        return;
+    }
+    //
+    //     And when  alpha.eq.zero.
+    //
+    if (alpha == zero) {
+        Rgemm_scale(m, n, beta, zero, one, c, ldc);
+        return;
+    }
+    Rsymm_panels(left, upper, m, n, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+} // namespace mpblas
+
+#endif
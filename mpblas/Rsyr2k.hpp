@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef ___MPBLAS_RSYR2K_H___
+#define ___MPBLAS_RSYR2K_H___
+
+#include <algorithm>
+#include <cstdint>
+#include "Mlsame.hpp"
+#include "Mxerbla.hpp"
+#include "Rsyrk.hpp"
+
+namespace mpblas {
+
+//
+//     C := alpha*A*B**T + alpha*B*A**T + beta*C (trans = 'N') or
+//     C := alpha*A**T*B + alpha*B**T*A + beta*C (trans = 'T' or 'C') on the
+//     upper or lower triangle of the n x n symmetric matrix C, A and B being
+//     n x k or k x n.  The two products are added to the triangle one after
+//     the other, beta being applied with the first.
+//
+template <typename REAL> void Rsyr2k(const char *uplo, const char *trans, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const bool upper = Mlsame(uplo, "U");
+    const bool nota = Mlsame(trans, "N");
+    const int64_t nrowa = nota ? n : k;
+    //
+    //     Test the input parameters.
+    //
+    int64_t info = 0;
+    if ((!upper) && (!Mlsame(uplo, "L"))) {
+        info = 1;
+    } else if ((!nota) && (!Mlsame(trans, "T")) && (!Mlsame(trans, "C"))) {
+        info = 2;
+    } else if (n < 0) {
+        info = 3;
+    } else if (k < 0) {
+        info = 4;
+    } else if (lda < std::max((int64_t)1, nrowa)) {
+        info = 7;
+    } else if (ldb < std::max((int64_t)1, nrowa)) {
+        info = 9;
+    } else if (ldc < std::max((int64_t)1, n)) {
+        info = 12;
+    }
+    if (info != 0) {
+        Mxerbla("Rsyr2k", info);
+        return;
+    }
+    //
+    //     Quick return if possible.
+    //
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    if ((n == 0) || (((alpha == zero) || (k == 0)) && (beta == one))) {
+        return;
+    }
+    //
+    //     And when  alpha.eq.zero.
+    //
+    if (alpha == zero) {
+        Rsyrk_scale(upper, (int64_t)0, n, n, beta, c, ldc);
+        return;
+    }
+    if (Rgemm_use_blocked<REAL>(n, n, k)) {
+        Rsyrk_blocked(upper, nota, !nota, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        Rsyrk_blocked(upper, nota, !nota, n, k, alpha, b, ldb, a, lda, one, c, ldc);
+        return;
+    }
+    Rsyrk_reference(upper, nota, !nota, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    Rsyrk_reference(upper, nota, !nota, n, k, alpha, b, ldb, a, lda, one, c, ldc);
+}
+} // namespace mpblas
+
+#endif
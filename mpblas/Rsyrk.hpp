@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef ___MPBLAS_RSYRK_H___
+#define ___MPBLAS_RSYRK_H___
+
+#include <algorithm>
+#include <cstdint>
+#include "Mlsame.hpp"
+#include "Mxerbla.hpp"
+#include "Mtrans.hpp"
+#include "Rgemm.hpp"
+#include "Rsyrk_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     C := alpha*op(A)*op(B) + beta*C on the upper or lower triangle of C by
+//     the reference loops of Rgemm, one column of the triangle at a time.
+//
+template <typename REAL> void Rsyrk_reference(bool const upper, bool const nota, bool const notb, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csb = notb ? ldb : 1;
+    for (int64_t j = 0; j < n; j++) {
+        const int64_t i0 = upper ? 0 : j;
+        const int64_t len = upper ? j + 1 : n - j;
+        REAL const *ai = &a[i0 * rsa];
+        REAL const *bj = &b[j * csb];
+        REAL *cj = &c[i0 + j * ldc];
+        if (nota) {
+            if (notb) {
+                Rgemm_reference<Mtrans::N, Mtrans::N>(len, (int64_t)1, k, alpha, ai, lda, bj, ldb, beta, cj, ldc);
+            } else {
+                Rgemm_reference<Mtrans::N, Mtrans::T>(len, (int64_t)1, k, alpha, ai, lda, bj, ldb, beta, cj, ldc);
+            }
+        } else {
+            if (notb) {
+                Rgemm_reference<Mtrans::T, Mtrans::N>(len, (int64_t)1, k, alpha, ai, lda, bj, ldb, beta, cj, ldc);
+            } else {
+                Rgemm_reference<Mtrans::T, Mtrans::T>(len, (int64_t)1, k, alpha, ai, lda, bj, ldb, beta, cj, ldc);
+            }
+        }
+    }
+}
+
+//
+//     C := alpha*A*A**T + beta*C (trans = 'N') or C := alpha*A**T*A + beta*C
+//     (trans = 'T' or 'C') on the upper or lower triangle of the n x n
+//     symmetric matrix C, A being n x k or k x n.  The other triangle is not
+//     referenced.
+//
+template <typename REAL> void Rsyrk(const char *uplo, const char *trans, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL const &beta, REAL *c, int64_t const ldc) {
+    const bool upper = Mlsame(uplo, "U");
+    const bool nota = Mlsame(trans, "N");
+    const int64_t nrowa = nota ? n : k;
+    //
+    //     Test the input parameters.
+    //
+    int64_t info = 0;
+    if ((!upper) && (!Mlsame(uplo, "L"))) {
+        info = 1;
+    } else if ((!nota) && (!Mlsame(trans, "T")) && (!Mlsame(trans, "C"))) {
+        info = 2;
+    } else if (n < 0) {
+        info = 3;
+    } else if (k < 0) {
+        info = 4;
+    } else if (lda < std::max((int64_t)1, nrowa)) {
+        info = 7;
+    } else if (ldc < std::max((int64_t)1, n)) {
+        info = 10;
+    }
+    if (info != 0) {
+        Mxerbla("Rsyrk ", info);
+        return;
+    }
+    //
+    //     Quick return if possible.
+    //
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    if ((n == 0) || (((alpha == zero) || (k == 0)) && (beta == one))) {
+        return;
+    }
+    //
+    //     And when  alpha.eq.zero.
+    //
+    if (alpha == zero) {
+        Rsyrk_scale(upper, (int64_t)0, n, n, beta, c, ldc);
+        return;
+    }
+    //
+    //     op(A) = A and op(B) = A**T, or the other way round.
+    //
+    if (Rgemm_use_blocked<REAL>(n, n, k)) {
+        Rsyrk_blocked(upper, nota, !nota, n, k, alpha, a, lda, a, lda, beta, c, ldc);
+        return;
+    }
+    Rsyrk_reference(upper, nota, !nota, n, k, alpha, a, lda, a, lda, beta, c, ldc);
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+The triangular product of Rsyrk and Rsyr2k on the blocked GEMM engine:
+    C := alpha*op(A)*op(B) + beta*C
+on the upper or lower triangle of the n x n matrix C only.  The loops are
+those of Rgemm_update with the same packing and micro-kernels, but register
+tiles of C outside the triangle are skipped and blocks of op(A) whose rows
+meet none of the triangle are not packed, so the work is about n*n*k/2
+multiply-adds instead of n*n*k.  A tile the diagonal crosses is formed in a
+copy of the tile and only its part in the triangle is stored back.
+Parallel runs cut the columns of C into stripes of equal triangle area, one
+or Rgemm_tasks_per_thread per thread on the work-stealing scheduler.  k is
+never split, so the result is bitwise identical for any number of threads.
+*/
+
+#ifndef ___MPBLAS_RSYRK_BLOCKED_H___
+#define ___MPBLAS_RSYRK_BLOCKED_H___
+
+#include <algorithm>
+#include <cmath>
+#include "Mbuffer.hpp"
+#include "Mparallel.hpp"
+#include "Mscheduler.hpp"
+#include "Mtrans.hpp"
+#include "Rgemm_blocked.hpp"
+
+namespace mpblas {
+
+//
+//     C := beta*C on the upper or lower triangle of columns [j0, j1) of the
+//     n x n matrix C.
+//
+template <typename REAL> void Rsyrk_scale(bool const upper, int64_t const j0, int64_t const j1, int64_t const n, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    for (int64_t j = j0; j < j1; j++) {
+        const int64_t i0 = upper ? 0 : j;
+        const int64_t i1 = upper ? j + 1 : n;
+        Rgemm_scale(i1 - i0, (int64_t)1, beta, zero, one, &c[i0 + j * ldc], ldc);
+    }
+}
+
+//
+//     Whether element (i, j) is in the upper or lower triangle.
+//
+inline bool Rsyrk_in(bool const upper, int64_t const i, int64_t const j) { return upper ? (i <= j) : (i >= j); }
+
+//
+//     The triangle of columns [j0, j1) of the n x n matrix C on the calling
+//     thread.  op(A) is n x k and op(B) k x n, both given in full.
+//
+template <typename REAL> void Rsyrk_update(bool const upper, bool const nota, bool const notb, int64_t const j0, int64_t const j1, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const REAL zero = 0.0;
+    const REAL one = 1.0;
+    if (j0 >= j1) {
+        return;
+    }
+    if (k == 0) {
+        Rsyrk_scale(upper, j0, j1, n, beta, c, ldc);
+        return;
+    }
+    //
+    //     The rows [i0, i1) of C that meet the triangle in these columns.
+    //
+    const int64_t i0 = upper ? 0 : j0;
+    const int64_t i1 = upper ? j1 : n;
+    const int64_t m = i1 - i0;
+    const int64_t rsa = nota ? 1 : lda;
+    const int64_t csa = nota ? lda : 1;
+    const int64_t rsb = notb ? 1 : ldb;
+    const int64_t csb = notb ? ldb : 1;
+    const int64_t mr = Rgemm_kernel<REAL>::mr();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    int64_t MC = 0;
+    int64_t KC = 0;
+    int64_t NC = 0;
+    Rgemm_blocks<REAL>(mr, nr, MC, KC, NC);
+    const int64_t mcmax = std::min(MC, (m + mr - 1) / mr * mr);
+    const int64_t ncmax = std::min(NC, (j1 - j0 + nr - 1) / nr * nr);
+    const int64_t kcmax = std::min(KC, k);
+    const int64_t ps = Rgemm_kernel<REAL>::packed_size;
+    typedef typename Rgemm_kernel<REAL>::packed_t PACKED;
+    Rgemm_workspace<PACKED> &work = Rgemm_workspace<PACKED>::local();
+    PACKED *apack = work.apack.reserve(mcmax * kcmax * ps);
+    PACKED *bpack = work.bpack.reserve(kcmax * ncmax * ps);
+    thread_local Mbuffer<REAL> tile;
+    REAL *ct = tile.reserve(mr * nr);
+    for (int64_t jc = j0; jc < j1; jc += NC) {
+        int64_t nc = std::min(NC, j1 - jc);
+        //
+        //     Rows of the triangle in columns [jc, jc + nc).
+        //
+        const int64_t r0 = upper ? i0 : jc;
+        const int64_t r1 = upper ? std::min(i1, jc + nc) : i1;
+        for (int64_t pc = 0; pc < k; pc += KC) {
+            int64_t kc = std::min(KC, k - pc);
+            REAL const &betapc = (pc == 0) ? beta : one;
+            const bool betazero = (betapc == zero);
+            Rgemm_kernel<REAL>::pack_b(kc, nc, &b[pc * rsb + jc * csb], rsb, csb, nr, bpack);
+            for (int64_t ic = r0; ic < r1; ic += MC) {
+                int64_t mc = std::min(MC, r1 - ic);
+                Rgemm_kernel<REAL>::pack_a(mc, kc, &a[ic * rsa + pc * csa], rsa, csa, mr, apack);
+                for (int64_t jr = 0; jr < nc; jr += nr) {
+                    for (int64_t ir = 0; ir < mc; ir += mr) {
+                        const int64_t mb = std::min(mr, mc - ir);
+                        const int64_t nb = std::min(nr, nc - jr);
+                        const int64_t gi = ic + ir;
+                        const int64_t gj = jc + jr;
+                        PACKED const *ap = &apack[ir * kc * ps];
+                        PACKED const *bp = &bpack[jr * kc * ps];
+                        REAL *cij = &c[gi + gj * ldc];
+                        //
+                        //     Skip tiles outside the triangle, update those
+                        //     inside it in place, and run the kernel on a copy
+                        //     ct of those on the diagonal, so that every
+                        //     element sees the same operations either way.
+                        //
+                        const bool outside = upper ? (gi > gj + nb - 1) : (gi + mb - 1 < gj);
+                        const bool inside = upper ? (gi + mb - 1 <= gj) : (gi >= gj + nb - 1);
+                        if (outside) {
+                            continue;
+                        }
+                        if (inside) {
+                            Rgemm_kernel<REAL>::run(kc, alpha, ap, bp, betapc, cij, ldc, mb, nb);
+                            continue;
+                        }
+                        for (int64_t j = 0; j < nb; j++) {
+                            for (int64_t i = 0; i < mb; i++) {
+                                ct[i + j * mr] = (betazero || !Rsyrk_in(upper, gi + i, gj + j)) ? zero : cij[i + j * ldc];
+                            }
+                        }
+                        Rgemm_kernel<REAL>::run(kc, alpha, ap, bp, betapc, ct, mr, mb, nb);
+                        for (int64_t j = 0; j < nb; j++) {
+                            for (int64_t i = 0; i < mb; i++) {
+                                if (Rsyrk_in(upper, gi + i, gj + j)) {
+                                    cij[i + j * ldc] = ct[i + j * mr];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+//     First column of stripe t of ntasks stripes of the triangle of an
+//     n x n matrix with equal areas, a multiple of align.
+//
+inline int64_t Rsyrk_stripe(bool const upper, int64_t const t, int64_t const ntasks, int64_t const n, int64_t const align) {
+    if (t >= ntasks) {
+        return n;
+    }
+    const double f = (double)t / (double)ntasks;
+    const double x = upper ? (double)n * std::sqrt(f) : (double)n * (1.0 - std::sqrt(1.0 - f));
+    return std::min(n, (int64_t)std::llround(x / (double)align) * align);
+}
+
+//
+//     C := alpha*op(A)*op(B) + beta*C on the upper or lower triangle of C.
+//     alpha is nonzero.
+//
+template <typename REAL> void Rsyrk_blocked(bool const upper, bool const nota, bool const notb, int64_t const n, int64_t const k, REAL const &alpha, REAL *a, int64_t const lda, REAL *b, int64_t const ldb, REAL const &beta, REAL *c, int64_t const ldc) {
+    const int64_t nthreads = std::min((int64_t)Mnum_threads(), n * n * std::max(k, (int64_t)1) / (2 * Rgemm_blocking<REAL>::work_per_thread));
+    if (nthreads <= 1) {
+        Rsyrk_update(upper, nota, notb, (int64_t)0, n, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    const int64_t ntasks = nthreads * Rgemm_tasks_per_thread<REAL>();
+    const int64_t nr = Rgemm_kernel<REAL>::nr();
+    Mparallel_tasks(ntasks, nthreads, [&](int64_t const t) { Rsyrk_update(upper, nota, notb, Rsyrk_stripe(upper, t, ntasks, n, nr), Rsyrk_stripe(upper, t + 1, ntasks, n, nr), n, k, alpha, a, lda, b, ldb, beta, c, ldc); });
+}
+} // namespace mpblas
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Support of mpf_class (gmpxx).
+Include this header (or mpblas.hpp after <gmpxx.h>) in every translation unit
+that uses mpblas with mpf_class; the order relative to the other mpblas
+headers and to <gmpxx.h> does not matter.  It selects the kernels of
+Rgemm_mpf.hpp and Cgemm_mpf.hpp, which run on per-thread mpf_t scratch, and
+holds the other specializations for mpf_class.
+*/
+
+#ifndef ___MPBLAS_GMP_H___
+#define ___MPBLAS_GMP_H___
+
+#include <climits>
+#include <cmath>
+#include <gmpxx.h>
+#include "Mtypes.hpp"
+#include "Rgemm_mpf.hpp"
+#include "Cgemm_mpf.hpp"
+#include "Cgemm_3m.hpp"
+#include "Rgemm_ozaki.hpp"
+#include "Rgemm_strassen.hpp"
+#include "Rgemm_tuning.hpp"
+#include "Rgemv_blocked.hpp"
+
+namespace mpblas {
+
+template <> struct Mtype_support<mpf_class> {
+    static constexpr bool included = true;
+};
+
+template <> struct Rgemm_tuning_name<mpf_class> {
+    static const char *name() { return "mpf_class"; }
+};
+
+//
+//     For mpf_class the products and the accumulators are per-thread mpf_t
+//     scratch (see Rgemm_mpf.hpp), so no temporaries are allocated.
+//
+template <> struct Rgemv_blocked_kernel<mpf_class> {
+    template <int64_t NC> static void n_block(int64_t const m, mpf_class const *t, mpf_class const *a, int64_t const lda, mpf_class *y) {
+        mpf_ptr tmp = Mmpf_scratch::local().get(1);
+        for (int64_t i = 0; i < m; i++) {
+            mpf_ptr yi = y[i].get_mpf_t();
+            for (int64_t c = 0; c < NC; c++) {
+                mpf_mul(tmp, t[c].get_mpf_t(), a[c * lda + i].get_mpf_t());
+                mpf_add(yi, yi, tmp);
+            }
+        }
+    }
+    template <int64_t NC, int64_t NA> static void t_block(int64_t const m, mpf_class const *a, int64_t const lda, mpf_class const *x, mpf_class *s) {
+        mpf_ptr acc = Mmpf_scratch::local().get(NC * NA + 1);
+        mpf_ptr tmp = &acc[NC * NA];
+        for (int64_t p = 0; p < NC * NA; p++) {
+            mpf_set_ui(&acc[p], 0);
+        }
+        for (int64_t i = 0; i < m; i++) {
+            mpf_srcptr xi = x[i].get_mpf_t();
+            for (int64_t c = 0; c < NC; c++) {
+                mpf_ptr sc = &acc[c * NA + i % NA];
+                mpf_mul(tmp, a[c * lda + i].get_mpf_t(), xi);
+                mpf_add(sc, sc, tmp);
+            }
+        }
+        for (int64_t c = 0; c < NC; c++) {
+            for (int64_t w = 1; w < NA; w *= 2) {
+                for (int64_t q = 0; q + w < NA; q += 2 * w) {
+                    mpf_add(&acc[c * NA + q], &acc[c * NA + q], &acc[c * NA + q + w]);
+                }
+            }
+            mpf_set(s[c].get_mpf_t(), &acc[c * NA]);
+        }
+    }
+};
+
+template <> struct Rgemm_ozaki_traits<mpf_class> {
+    static constexpr bool enabled = true;
+    static int digits() { return (int)mpf_get_default_prec(); }
+    static int exponent(mpf_class const &x) {
+        if (mpf_sgn(x.get_mpf_t()) == 0) {
+            return INT_MIN;
+        }
+        signed long e;
+        mpf_get_d_2exp(&e, x.get_mpf_t());
+        return (int)e;
+    }
+    static void scale(mpf_ptr x, int const e) {
+        if (e >= 0) {
+            mpf_mul_2exp(x, x, e);
+        } else {
+            mpf_div_2exp(x, x, -e);
+        }
+    }
+    static void scale(mpf_class &x, int const e) { scale(x.get_mpf_t(), e); }
+    static void add(mpf_class &x, double const d) {
+        mpf_ptr t = Mmpf_scratch::local().get(1);
+        mpf_set_d(t, d);
+        mpf_add(x.get_mpf_t(), x.get_mpf_t(), t);
+    }
+    static void split(mpf_class const &x, int const e, int const beta, int64_t const S, double *out, int64_t const stride) {
+        mpf_ptr r = Mmpf_scratch::local().get(2);
+        mpf_ptr t = &r[1];
+        mpf_set(r, x.get_mpf_t());
+        scale(r, beta - e);
+        for (int64_t s = 0; s < S; s++) {
+            double slice = std::nearbyint(mpf_get_d(r));
+            out[s * stride] = slice;
+            mpf_set_d(t, slice);
+            mpf_sub(r, r, t);
+            mpf_mul_2exp(r, r, beta);
+        }
+    }
+};
+
+template <> struct Rgemm_strassen_traits<mpf_class> {
+    static constexpr bool automatic = true;
+    static int64_t crossover() { return 64; }
+};
+
+template <> struct Cgemm_3m_traits<mpf_class> {
+    static constexpr bool automatic = true;
+};
+} // namespace mpblas
+
+#endif
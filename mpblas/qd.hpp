@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2008-2022
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+Support of the libqd types dd_real and qd_real.
+Include this header (or mpblas.hpp after <qd/qd_real.h>) in every translation
+unit that uses mpblas with dd_real or qd_real; the order relative to the other
+mpblas headers and to libqd's own does not matter.  It selects the limb
+kernels (Rgemm_qd.hpp and the *_limbs templates of the routines) and the
+per-type settings below.
+*/
+
+#ifndef ___MPBLAS_QD_H___
+#define ___MPBLAS_QD_H___
+
+#include <qd/dd_real.h>
+#include <qd/qd_real.h>
+#include "Mtypes.hpp"
+#include "Raxpy_simd.hpp"
+#include "Rgemm_blocked.hpp"
+#include "Rgemm_fixed.hpp"
+#include "Rgemm_ozaki.hpp"
+#include "Rgemm_qd.hpp"
+#include "Rgemm_strassen.hpp"
+#include "Rgemm_tuning.hpp"
+#include "Rgemv_blocked.hpp"
+#include "Cgemm_3m.hpp"
+
+namespace mpblas {
+
+template <> struct Mtype_support<dd_real> {
+    static constexpr bool included = true;
+};
+template <> struct Mtype_support<qd_real> {
+    static constexpr bool included = true;
+};
+
+template <> struct Rgemm_tuning_name<dd_real> {
+    static const char *name() { return "dd_real"; }
+};
+template <> struct Rgemm_tuning_name<qd_real> {
+    static const char *name() { return "qd_real"; }
+};
+
+template <> struct Rgemm_kernel<dd_real> : Rgemm_kernel_limbs<dd_real, 2> {};
+template <> struct Rgemm_shapes<dd_real> : Rgemm_shapes_limbs<dd_real, 2> {};
+template <typename TIN> struct Rgemm_widen<TIN, dd_real> : Rgemm_widen_limbs<TIN, 2> {};
+template <> struct Rgemm_kernel<qd_real> : Rgemm_kernel_limbs<qd_real, 4> {};
+template <> struct Rgemm_shapes<qd_real> : Rgemm_shapes_limbs<qd_real, 4> {};
+template <typename TIN> struct Rgemm_widen<TIN, qd_real> : Rgemm_widen_limbs<TIN, 4> {};
+
+template <> struct Rgemm_fixed_kernel<dd_real> : Rgemm_fixed_limbs<dd_real, 2> {};
+template <> struct Rgemm_fixed_kernel<qd_real> : Rgemm_fixed_limbs<qd_real, 4> {};
+
+template <> struct Rgemv_blocked_kernel<dd_real> : Rgemv_blocked_limbs<dd_real, 2> {};
+template <> struct Rgemv_blocked_kernel<qd_real> : Rgemv_blocked_limbs<qd_real, 4> {};
+
+template <> struct Raxpy_kernel<dd_real> : Raxpy_kernel_dd<dd_real> {};
+
+template <> struct Rgemm_ozaki_traits<dd_real> : Rgemm_ozaki_limbs<dd_real, 2, 106> {};
+template <> struct Rgemm_ozaki_traits<qd_real> : Rgemm_ozaki_limbs<qd_real, 4, 212> {};
+
+template <> struct Rgemm_strassen_traits<dd_real> {
+    static constexpr bool automatic = true;
+    static int64_t crossover() { return 512; }
+};
+template <> struct Rgemm_strassen_traits<qd_real> {
+    static constexpr bool automatic = true;
+    static int64_t crossover() { return 512; }
+};
+
+template <> struct Cgemm_3m_traits<dd_real> {
+    static constexpr bool automatic = true;
+};
+template <> struct Cgemm_3m_traits<qd_real> {
+    static constexpr bool automatic = true;
+};
+} // namespace mpblas
+
+#endif